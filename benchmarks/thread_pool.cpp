@@ -0,0 +1,71 @@
+// Copyright (c) 2026 Miklos Molnar. All rights reserved.
+
+#include <benchpress.hpp>
+
+#include <shard/concurrency/thread_pool.hpp>
+
+#include <atomic>
+#include <thread>
+
+namespace {
+
+constexpr std::size_t g_task_count = 1024;
+
+void run_tasks(shard::thread_pool& pool, std::size_t count) {
+    std::atomic<std::size_t> done = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        pool.run([&done] { done.fetch_add(1, std::memory_order_relaxed); });
+    }
+    while (done.load(std::memory_order_relaxed) != count) {
+        std::this_thread::yield();
+    }
+}
+
+void run_nested_tasks(shard::thread_pool& pool, std::size_t count) {
+    std::atomic<std::size_t> done = 0;
+    auto fan_out = pool.thread_count();
+    for (std::size_t i = 0; i < fan_out; ++i) {
+        pool.run([&pool, &done, count, fan_out] {
+            for (std::size_t j = 0; j < count / fan_out; ++j) {
+                pool.run([&done] { done.fetch_add(1, std::memory_order_relaxed); });
+            }
+        });
+    }
+    while (done.load(std::memory_order_relaxed) != (count / fan_out) * fan_out) {
+        std::this_thread::yield();
+    }
+}
+
+} // namespace
+
+BENCHMARK("thread_pool (shared_queue)", [](benchpress::context* ctx) {
+    shard::thread_pool pool(shard::scheduling_t::shared_queue);
+    ctx->reset_timer();
+    for (std::size_t i = 0; i < ctx->num_iterations(); ++i) {
+        run_tasks(pool, g_task_count);
+    }
+})
+
+BENCHMARK("thread_pool (work_stealing)", [](benchpress::context* ctx) {
+    shard::thread_pool pool(shard::scheduling_t::work_stealing);
+    ctx->reset_timer();
+    for (std::size_t i = 0; i < ctx->num_iterations(); ++i) {
+        run_tasks(pool, g_task_count);
+    }
+})
+
+BENCHMARK("thread_pool nested (shared_queue)", [](benchpress::context* ctx) {
+    shard::thread_pool pool(shard::scheduling_t::shared_queue);
+    ctx->reset_timer();
+    for (std::size_t i = 0; i < ctx->num_iterations(); ++i) {
+        run_nested_tasks(pool, g_task_count);
+    }
+})
+
+BENCHMARK("thread_pool nested (work_stealing)", [](benchpress::context* ctx) {
+    shard::thread_pool pool(shard::scheduling_t::work_stealing);
+    ctx->reset_timer();
+    for (std::size_t i = 0; i < ctx->num_iterations(); ++i) {
+        run_nested_tasks(pool, g_task_count);
+    }
+})
@@ -0,0 +1,37 @@
+// Copyright (c) 2026 Miklos Molnar. All rights reserved.
+
+#include <shard/algorithm/enumerate.hpp>
+#include <shard/concurrency/parallel.hpp>
+
+#include <cmath>
+#include <iostream>
+#include <numeric>
+#include <vector>
+
+int main() {
+    shard::thread_pool pool(shard::scheduling_t::work_stealing);
+
+    std::vector<double> values(1'000'000);
+    std::iota(values.begin(), values.end(), 1.0);
+
+    // the range is split into chunks automatically
+    shard::parallel_for(pool, values, [](double& value) { value = std::sqrt(value); });
+
+    // ranges from 'shard::enumerate' work as well
+    shard::parallel_for(pool, shard::enumerate(values), 4096, [](auto& item) {
+        if (item.index() % 2 == 1) {
+            item.value() = -item.value();
+        }
+    });
+
+    auto sum = shard::parallel_reduce(pool, values, 0.0, [](double a, double b) { return a + b; });
+    std::cout << "sum: " << sum << '\n';
+
+    std::vector<double> squares(values.size());
+    shard::parallel_transform(pool, values, squares.begin(), [](double value) { return value * value; });
+
+    shard::parallel_sort(pool, squares.begin(), squares.end());
+    std::cout << "min: " << squares.front() << ", max: " << squares.back() << '\n';
+
+    return 0;
+}
@@ -2,11 +2,19 @@
 
 #include <shard/concurrency/this_thread.hpp>
 
+#include <iostream>
 #include <thread>
 
 static void thread_fn() {
     shard::this_thread::set_name("MyThread");
     // enter debugger to verify thread name
+
+    // pin the thread to the first CPU it is allowed to run on
+    shard::cpu_set cpus;
+    cpus.add(shard::this_thread::affinity().nth(0));
+    if (shard::this_thread::set_affinity(cpus)) {
+        std::cout << "running on CPU " << shard::this_thread::current_cpu().value_or(0) << '\n';
+    }
 }
 
 int main(int /* argc */, char* /* argv */[]) {
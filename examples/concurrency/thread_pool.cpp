@@ -3,6 +3,7 @@
 #include <shard/concurrency/thread_pool.hpp>
 
 #include <iostream>
+#include <string>
 
 static void foo() {
     std::cout << "foo()\n";
@@ -31,6 +32,11 @@ int main() {
     widget w("quack");
     threads.run(&widget::baz, std::ref(w));
 
+    auto answer = threads.submit([](int a, int b) { return a * b; }, 6, 7).then([](int n) {
+        return "the answer is " + std::to_string(n);
+    });
+    std::cout << answer.get() << '\n';
+
     std::this_thread::sleep_for(std::chrono::milliseconds(50));
 
     return 0;
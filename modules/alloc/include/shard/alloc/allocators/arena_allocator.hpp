@@ -0,0 +1,190 @@
+// Copyright (c) 2026 Miklos Molnar. All rights reserved.
+
+#pragma once
+
+#include "shard/alloc/allocator.hpp"
+
+#include <shard/memory/utils.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+
+namespace shard {
+namespace memory {
+
+/// Linear allocator growing by chaining blocks from an upstream allocator
+///
+/// Allocations bump a pointer in the current block. When it is full, a new
+/// block is allocated from the upstream allocator, each one twice the size of
+/// the previous one. Memory is only reclaimed by rewinding to a marker or by
+/// resetting the whole arena.
+///
+/// Blocks released by 'rewind()' and 'reset()' are returned to the upstream
+/// allocator, except for the largest one, which is kept for the next
+/// allocations.
+class arena_allocator : public allocator {
+public:
+    /// Position in the arena to rewind to
+    struct marker {
+        void* block;
+        void* next;
+        std::size_t used_memory;
+        std::size_t allocation_count;
+    };
+
+public:
+    /// Create a new arena starting with a block of 'block_size' bytes, it is
+    /// only allocated on first use
+    explicit arena_allocator(allocator& upstream, std::size_t block_size = 4096)
+    : allocator(0)
+    , m_upstream(upstream)
+    , m_next_block_size(block_size) {
+        assert(block_size > header_size);
+    }
+
+    arena_allocator(const arena_allocator&) = delete;
+    arena_allocator& operator=(const arena_allocator&) = delete;
+
+    ~arena_allocator() override {
+        release_blocks(nullptr);
+        if (m_spare) {
+            m_upstream.deallocate(m_spare);
+        }
+        // destroying the arena frees every allocation
+        m_used_memory = 0;
+        m_allocation_count = 0;
+    }
+
+    void* allocate(std::size_t size, std::size_t align) override {
+        assert(size != 0 && align != 0);
+
+        auto padding = get_padding(m_next, align);
+        if (!m_current || as_uint(m_next) + padding + size > as_uint(m_end)) {
+            if (!grow(size, align)) {
+                return nullptr;
+            }
+            padding = get_padding(m_next, align);
+        }
+
+        // properly align the object
+        auto aligned_address = as_uint(m_next) + padding;
+        m_next = as_ptr(aligned_address + size);
+        m_used_memory += padding + size;
+        ++m_allocation_count;
+
+        return as_ptr(aligned_address);
+    }
+
+    void deallocate(void* /* ptr */) override {
+        // no-op, use 'rewind()' or 'reset()'
+    }
+
+    /// Get the current position to rewind to later
+    marker mark() const noexcept { return {m_current, m_next, m_used_memory, m_allocation_count}; }
+
+    /// Free every allocation made since the marker was taken
+    ///
+    /// \warning Markers taken after this one, or before a 'reset()', must not
+    ///          be used anymore.
+    void rewind(const marker& m) {
+        release_blocks(static_cast<block*>(m.block));
+        if (m_current) {
+            m_next = m.next;
+        }
+        m_used_memory = m.used_memory;
+        m_allocation_count = m.allocation_count;
+    }
+
+    /// Free every allocation, keeping the largest block for reuse
+    void reset() {
+        release_blocks(nullptr);
+        if (m_spare) {
+            // reuse the kept block right away
+            use_block(std::exchange(m_spare, nullptr));
+        }
+        m_used_memory = 0;
+        m_allocation_count = 0;
+    }
+
+    /// Get the number of blocks allocated from the upstream allocator
+    std::size_t block_count() const noexcept {
+        std::size_t count = m_spare ? 1 : 0;
+        for (auto b = m_current; b; b = b->prev) {
+            ++count;
+        }
+        return count;
+    }
+
+private:
+    struct block {
+        block* prev;
+        std::size_t size;
+    };
+
+    static constexpr auto header_size = sizeof(block);
+
+private:
+    // continue in a new block with room for the allocation
+    bool grow(std::size_t size, std::size_t align) {
+        auto required = header_size + size + align - 1;
+        if (m_spare && m_spare->size >= required) {
+            use_block(std::exchange(m_spare, nullptr));
+            return true;
+        }
+
+        auto block_size = std::max(m_next_block_size, required);
+        auto memory = m_upstream.allocate(block_size, alignof(block));
+        if (!memory) {
+            return false;
+        }
+        m_next_block_size = block_size * 2;
+        m_size += block_size;
+        use_block(new (memory) block {nullptr, block_size});
+        return true;
+    }
+
+    void use_block(block* b) noexcept {
+        b->prev = m_current;
+        m_current = b;
+        m_next = add(b, header_size);
+        m_end = add(b, b->size);
+    }
+
+    // free the blocks allocated after the given one, keeping the largest one
+    // as spare
+    void release_blocks(block* last) {
+        while (m_current != last) {
+            auto b = std::exchange(m_current, m_current->prev);
+            if (!m_spare || m_spare->size < b->size) {
+                std::swap(b, m_spare);
+            }
+            if (b) {
+                m_size -= b->size;
+                m_upstream.deallocate(b);
+            }
+        }
+        if (m_current) {
+            m_end = add(m_current, m_current->size);
+        } else {
+            m_next = nullptr;
+            m_end = nullptr;
+        }
+    }
+
+private:
+    allocator& m_upstream;
+    std::size_t m_next_block_size;
+    block* m_current = nullptr;
+    block* m_spare = nullptr;
+    void* m_next = nullptr;
+    void* m_end = nullptr;
+};
+
+} // namespace memory
+
+// bring symbols into parent namespace
+
+using memory::arena_allocator;
+
+} // namespace shard
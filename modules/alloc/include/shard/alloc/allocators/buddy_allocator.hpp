@@ -0,0 +1,255 @@
+// Copyright (c) 2026 Miklos Molnar. All rights reserved.
+
+#pragma once
+
+#include "shard/alloc/allocator.hpp"
+
+#include <shard/memory/utils.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace shard {
+namespace memory {
+
+/// Allocator splitting the memory into blocks of power of two multiples of a
+/// minimum block size
+///
+/// Every allocation is rounded up to the next block size. Larger blocks are
+/// split in halves (buddies) until one of the right size remains, freed
+/// blocks are merged with their buddy as long as it is free too. There is a
+/// list of free blocks for every order, a bitmap marking the free blocks finds
+/// the buddy of a block in O(1).
+///
+/// The bookkeeping (the requested size, a byte and a bit per minimum block) is
+/// stored at the start of the memory.
+///
+/// \note The used memory counts whole blocks, the difference to
+///       'requested_memory()' is the internal fragmentation. Alignments larger
+///       than the minimum block size are not served.
+class buddy_allocator : public allocator {
+public:
+    /// Create a new allocator over the memory, 'min_block_size' must be a
+    /// power of 2
+    buddy_allocator(void* data, std::size_t size, std::size_t min_block_size = 4096)
+    : allocator(size)
+    , m_min_block_size(min_block_size) {
+        assert(min_block_size >= sizeof(free_block) && (min_block_size & (min_block_size - 1)) == 0);
+        m_min_shift = find_last_set(min_block_size);
+
+        // reserve room for the bookkeeping of every block that could fit,
+        // then align the blocks
+        auto capacity = size / min_block_size;
+        m_sizes = static_cast<std::size_t*>(align(data, alignof(std::size_t)));
+        m_orders = reinterpret_cast<std::uint8_t*>(m_sizes + capacity);
+        m_free_bits = m_orders + capacity;
+        m_base = align(m_free_bits + (capacity + 7) / 8, min_block_size);
+        auto available = as_uint(data) + size > as_uint(m_base) ? as_uint(data) + size - as_uint(m_base) : 0;
+        m_block_count = available / min_block_size;
+        assert(m_block_count > 0);
+        std::memset(m_free_bits, 0, (m_block_count + 7) / 8);
+
+        // cover the memory with the largest blocks possible, each one is
+        // aligned to its size relative to the base
+        m_max_order = find_last_set(m_block_count);
+        std::size_t index = 0;
+        for (auto order = m_max_order + 1; order-- > 0;) {
+            if (m_block_count & (std::size_t(1) << order)) {
+                push_free(index, order);
+                index += std::size_t(1) << order;
+            }
+        }
+    }
+
+    buddy_allocator(const buddy_allocator&) = delete;
+    buddy_allocator& operator=(const buddy_allocator&) = delete;
+
+    void* allocate(std::size_t size, std::size_t align) override {
+        assert(size != 0 && align != 0);
+
+        if (align > m_min_block_size) {
+            return nullptr;
+        }
+
+        auto order = order_of(size);
+        if (order > m_max_order) {
+            return nullptr;
+        }
+        // the smallest order with a free block
+        auto orders = m_free_orders & (~std::uint64_t(0) << order);
+        if (orders == 0) {
+            return nullptr;
+        }
+        auto current = find_first_set(orders);
+        auto index = pop_free(current);
+
+        // split the block, keeping the first half
+        while (current > order) {
+            --current;
+            push_free(index + (std::size_t(1) << current), current);
+        }
+        m_orders[index] = static_cast<std::uint8_t>(order);
+        m_sizes[index] = size;
+
+        m_used_memory += block_size(order);
+        m_requested_memory += size;
+        ++m_allocation_count;
+
+        return add(m_base, index << m_min_shift);
+    }
+
+    void deallocate(void* ptr) override {
+        assert(ptr);
+
+        auto index = (as_uint(ptr) - as_uint(m_base)) >> m_min_shift;
+        assert(index < m_block_count && !is_free(index));
+        auto order = static_cast<std::size_t>(m_orders[index]);
+
+        m_used_memory -= block_size(order);
+        m_requested_memory -= m_sizes[index];
+        --m_allocation_count;
+
+        // merge with the buddy while it is a free block of the same order
+        while (order < m_max_order) {
+            auto buddy = index ^ (std::size_t(1) << order);
+            if (buddy >= m_block_count || !is_free(buddy) || m_orders[buddy] != order) {
+                break;
+            }
+            remove_free(buddy, order);
+            index = index < buddy ? index : buddy;
+            ++order;
+        }
+        push_free(index, order);
+    }
+
+    /// Get the sum of the sizes requested by the current allocations
+    std::size_t requested_memory() const noexcept { return m_requested_memory; }
+
+    /// Get the size of the block used for an allocation of the given size
+    std::size_t block_size_for(std::size_t size) const noexcept { return block_size(order_of(size)); }
+
+    /// Get the size of the smallest blocks
+    std::size_t min_block_size() const noexcept { return m_min_block_size; }
+
+    /// Get the size of the largest blocks
+    std::size_t max_block_size() const noexcept { return block_size(m_max_order); }
+
+private:
+    // overlays the memory of a free block
+    struct free_block {
+        free_block* next;
+        free_block* prev;
+    };
+
+    static constexpr std::size_t max_order_count = 64;
+
+private:
+    // index of the lowest set bit, the value must not be 0
+    static std::size_t find_first_set(std::uint64_t value) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<std::size_t>(__builtin_ctzll(value));
+#else
+        std::size_t i = 0;
+        for (; (value & 1) == 0; value >>= 1) {
+            ++i;
+        }
+        return i;
+#endif
+    }
+
+    // index of the highest set bit, the value must not be 0
+    static std::size_t find_last_set(std::uint64_t value) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        return 63 - static_cast<std::size_t>(__builtin_clzll(value));
+#else
+        std::size_t i = 0;
+        for (; value > 1; value >>= 1) {
+            ++i;
+        }
+        return i;
+#endif
+    }
+
+    std::size_t block_size(std::size_t order) const noexcept { return m_min_block_size << order; }
+
+    std::size_t order_of(std::size_t size) const noexcept {
+        auto blocks = (size + m_min_block_size - 1) >> m_min_shift;
+        return blocks <= 1 ? 0 : find_last_set(blocks - 1) + 1;
+    }
+
+    free_block* block_at(std::size_t index) const noexcept {
+        return static_cast<free_block*>(add(m_base, index << m_min_shift));
+    }
+
+    bool is_free(std::size_t index) const noexcept { return m_free_bits[index / 8] & (1u << (index % 8)); }
+
+    void set_free(std::size_t index, bool is_free) noexcept {
+        if (is_free) {
+            m_free_bits[index / 8] |= static_cast<std::uint8_t>(1u << (index % 8));
+        } else {
+            m_free_bits[index / 8] &= static_cast<std::uint8_t>(~(1u << (index % 8)));
+        }
+    }
+
+    void push_free(std::size_t index, std::size_t order) noexcept {
+        auto b = block_at(index);
+        auto& head = m_free[order];
+        b->prev = nullptr;
+        b->next = head;
+        if (head) {
+            head->prev = b;
+        }
+        head = b;
+        m_orders[index] = static_cast<std::uint8_t>(order);
+        set_free(index, true);
+        m_free_orders |= std::uint64_t(1) << order;
+    }
+
+    std::size_t pop_free(std::size_t order) noexcept {
+        auto index = (as_uint(m_free[order]) - as_uint(m_base)) >> m_min_shift;
+        remove_free(index, order);
+        return index;
+    }
+
+    void remove_free(std::size_t index, std::size_t order) noexcept {
+        auto b = block_at(index);
+        if (b->prev) {
+            b->prev->next = b->next;
+        } else {
+            m_free[order] = b->next;
+            if (!b->next) {
+                m_free_orders &= ~(std::uint64_t(1) << order);
+            }
+        }
+        if (b->next) {
+            b->next->prev = b->prev;
+        }
+        set_free(index, false);
+    }
+
+private:
+    std::size_t m_min_block_size;
+    std::size_t m_min_shift = 0;
+    std::size_t m_max_order = 0;
+    std::size_t m_block_count = 0;
+    std::size_t m_requested_memory = 0;
+    void* m_base = nullptr;
+    // the requested size of the allocation starting at every minimum block
+    std::size_t* m_sizes = nullptr;
+    // the order of the block starting at every minimum block
+    std::uint8_t* m_orders = nullptr;
+    // the minimum blocks starting a free block
+    std::uint8_t* m_free_bits = nullptr;
+    // the orders with free blocks
+    std::uint64_t m_free_orders = 0;
+    free_block* m_free[max_order_count] = {};
+};
+
+} // namespace memory
+
+// bring symbols into parent namespace
+
+using memory::buddy_allocator;
+
+} // namespace shard
@@ -0,0 +1,265 @@
+// Copyright (c) 2026 Miklos Molnar. All rights reserved.
+
+#pragma once
+
+#include "shard/alloc/allocator.hpp"
+
+#include <shard/memory/utils.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace shard {
+namespace memory {
+
+/// Allocator serving small objects from slabs dedicated to size classes
+///
+/// Every request is rounded up to one of the size classes, each class keeps a
+/// list of slabs with free objects. The slabs are aligned to their size, so
+/// the slab of an object (and its class) is found by masking the address,
+/// making both allocation and deallocation O(1).
+///
+/// Slabs are carved from chunks allocated from the backing allocator. Empty
+/// slabs are kept for reuse by any size class, the chunks are only returned
+/// when the allocator is destroyed.
+///
+/// \note Allocations larger than 'max_size()' or aligned to more than
+///       'max_align()' are not served, use a general purpose allocator for
+///       them.
+class slab_allocator : public allocator {
+public:
+    /// The smallest possible size of a slab
+    static constexpr std::size_t min_slab_size = 4096;
+
+public:
+    /// Create a new allocator carving 'slabs_per_chunk' slabs of 'slab_size'
+    /// bytes at once from the backing allocator
+    ///
+    /// \note The slab size must be a power of 2.
+    explicit slab_allocator(allocator& backing, std::size_t slab_size = 16384, std::size_t slabs_per_chunk = 16)
+    : allocator(0)
+    , m_backing(backing)
+    , m_slab_size(slab_size)
+    , m_slabs_per_chunk(slabs_per_chunk) {
+        assert(slab_size >= min_slab_size && (slab_size & (slab_size - 1)) == 0);
+        assert(slabs_per_chunk > 0);
+    }
+
+    slab_allocator(const slab_allocator&) = delete;
+    slab_allocator& operator=(const slab_allocator&) = delete;
+
+    ~slab_allocator() override {
+        while (m_chunks) {
+            m_backing.deallocate(std::exchange(m_chunks, m_chunks->next));
+        }
+    }
+
+    void* allocate(std::size_t size, std::size_t align) override {
+        assert(size != 0 && align != 0);
+
+        auto c = class_index(size, align);
+        if (c == class_count) {
+            return nullptr;
+        }
+
+        auto s = m_partial[c];
+        if (!s && !(s = acquire_slab(c))) {
+            return nullptr;
+        }
+
+        // reuse a freed object before touching new memory
+        void* ptr;
+        if (s->free_list) {
+            ptr = s->free_list;
+            s->free_list = *reinterpret_cast<void**>(ptr);
+        } else {
+            ptr = s->unused;
+            s->unused = add(s->unused, s->object_size);
+        }
+
+        if (++s->used == s->capacity) {
+            unlink(s);
+        }
+
+        assert(is_aligned(ptr, align));
+
+        m_used_memory += s->object_size;
+        ++m_allocation_count;
+
+        return ptr;
+    }
+
+    void deallocate(void* ptr) override {
+        assert(ptr);
+
+        auto s = slab_of(ptr);
+        auto is_full = s->used == s->capacity;
+
+        *reinterpret_cast<void**>(ptr) = s->free_list;
+        s->free_list = ptr;
+        --s->used;
+
+        m_used_memory -= s->object_size;
+        --m_allocation_count;
+
+        if (is_full) {
+            link(s);
+        } else if (s->used == 0 && (m_partial[s->size_class] != s || s->next)) {
+            // keep the last slab of the class to avoid thrashing
+            unlink(s);
+            release_slab(s);
+        }
+    }
+
+    /// Get the size of the memory block used for the allocation, 0 if it is
+    /// not served by the allocator
+    static std::size_t block_size(std::size_t size, std::size_t align) noexcept {
+        auto c = class_index(size, align);
+        return c != class_count ? class_sizes[c] : 0;
+    }
+
+    /// Get the size of the largest allocation served
+    static constexpr std::size_t max_size() noexcept { return class_sizes[class_count - 1]; }
+
+    /// Get the largest alignment served
+    static constexpr std::size_t max_align() noexcept { return header_size; }
+
+    /// Get the size of a slab
+    std::size_t slab_size() const noexcept { return m_slab_size; }
+
+private:
+    struct slab {
+        // links in the list of slabs with free objects of the class
+        slab* prev;
+        slab* next;
+        // freed objects, then the never used ones from 'unused'
+        void* free_list;
+        void* unused;
+        std::size_t used;
+        std::size_t capacity;
+        std::size_t object_size;
+        std::size_t size_class;
+    };
+
+    struct chunk {
+        chunk* next;
+    };
+
+    static constexpr std::size_t class_count = 20;
+
+    // 16 byte steps up to 128, then 4 classes for every doubling
+    static constexpr std::array<std::size_t, class_count> class_sizes = {
+        16, 32, 48, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384, 448, 512, 640, 768, 896, 1024};
+
+    // the objects start at the first cache line after the header
+    static constexpr std::size_t header_size = 64;
+    static_assert(sizeof(slab) <= header_size);
+
+    // the smallest class of every size rounded up to 16 bytes
+    static constexpr std::array<std::uint8_t, 1024 / 16> class_lookup = [] {
+        std::array<std::uint8_t, 1024 / 16> lookup {};
+        std::size_t c = 0;
+        for (std::size_t i = 0; i < lookup.size(); ++i) {
+            while (class_sizes[c] < (i + 1) * 16) {
+                ++c;
+            }
+            lookup[i] = static_cast<std::uint8_t>(c);
+        }
+        return lookup;
+    }();
+
+private:
+    static std::size_t class_index(std::size_t size, std::size_t align) noexcept {
+        if (size > max_size() || align > max_align()) {
+            return class_count;
+        }
+        std::size_t c = class_lookup[(size - 1) / 16];
+        // the slabs are aligned, so objects are aligned to every divisor of
+        // their size
+        while (c < class_count && class_sizes[c] % align != 0) {
+            ++c;
+        }
+        return c;
+    }
+
+    slab* slab_of(void* ptr) const noexcept { return reinterpret_cast<slab*>(as_uint(ptr) & ~(m_slab_size - 1)); }
+
+    // take an empty slab and make it the first one with free objects of the
+    // class
+    slab* acquire_slab(std::size_t c) {
+        if (!m_free_slabs && !grow()) {
+            return nullptr;
+        }
+
+        auto s = std::exchange(m_free_slabs, m_free_slabs->next);
+        s->free_list = nullptr;
+        s->unused = add(s, header_size);
+        s->used = 0;
+        s->object_size = class_sizes[c];
+        s->capacity = (m_slab_size - header_size) / s->object_size;
+        s->size_class = c;
+        link(s);
+        return s;
+    }
+
+    void release_slab(slab* s) noexcept {
+        s->next = m_free_slabs;
+        m_free_slabs = s;
+    }
+
+    // carve new slabs from a chunk of the backing allocator
+    bool grow() {
+        // the chunk has room for aligning the first slab
+        auto raw = m_backing.allocate(m_slabs_per_chunk * m_slab_size + m_slab_size + sizeof(chunk), alignof(chunk));
+        if (!raw) {
+            return false;
+        }
+
+        m_chunks = new (raw) chunk {m_chunks};
+        auto first = align(add(raw, sizeof(chunk)), m_slab_size);
+        for (std::size_t i = 0; i < m_slabs_per_chunk; ++i) {
+            release_slab(new (add(first, i * m_slab_size)) slab {});
+        }
+        m_size += m_slabs_per_chunk * m_slab_size;
+        return true;
+    }
+
+    void link(slab* s) noexcept {
+        auto& head = m_partial[s->size_class];
+        s->prev = nullptr;
+        s->next = head;
+        if (head) {
+            head->prev = s;
+        }
+        head = s;
+    }
+
+    void unlink(slab* s) noexcept {
+        if (s->prev) {
+            s->prev->next = s->next;
+        } else {
+            m_partial[s->size_class] = s->next;
+        }
+        if (s->next) {
+            s->next->prev = s->prev;
+        }
+    }
+
+private:
+    allocator& m_backing;
+    std::size_t m_slab_size;
+    std::size_t m_slabs_per_chunk;
+    std::array<slab*, class_count> m_partial {};
+    slab* m_free_slabs = nullptr;
+    chunk* m_chunks = nullptr;
+};
+
+} // namespace memory
+
+// bring symbols into parent namespace
+
+using memory::slab_allocator;
+
+} // namespace shard
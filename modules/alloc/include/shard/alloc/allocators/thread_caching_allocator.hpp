@@ -0,0 +1,431 @@
+// Copyright (c) 2026 Miklos Molnar. All rights reserved.
+
+#pragma once
+
+#include "shard/alloc/allocator.hpp"
+
+#include <shard/memory/utils.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace shard {
+namespace memory {
+
+/// Thread-safe front-end caching blocks of a backing allocator per thread
+///
+/// Every thread gets a cache of blocks for each power of two size class up to
+/// 'max_size()'. Allocations and deallocations by the thread owning a block
+/// only touch its own cache, the backing allocator is locked to exchange
+/// blocks in batches when a cache runs empty or overflows.
+///
+/// Blocks remember the cache they were created for. Blocks freed by another
+/// thread are pushed onto a lock-free list of their owner, which takes them
+/// back once its own blocks of the class run out.
+///
+/// Every cache counts the allocations of its thread, the counters of the
+/// allocator are only updated to their sum when a thread exchanges blocks
+/// with the backing allocator or calls 'flush()'.
+///
+/// \warning 'used_memory()' and 'allocation_count()' must not be called while
+///          other threads use the allocator, call 'stats()' instead.
+///
+/// The cache of an exited thread is adopted by the next thread taking the
+/// lock, which returns its blocks to the backing allocator, including the ones
+/// freed to it later, and drops it once none of its blocks are in use.
+///
+/// \note Allocations larger than 'max_size()' or aligned to more than 16 bytes
+///       are forwarded to the backing allocator under the lock.
+class thread_caching_allocator : public allocator {
+public:
+    /// The number of blocks a thread caches per size class
+    static constexpr std::size_t cache_capacity = 32;
+
+    /// The counters of every thread summed up
+    struct statistics {
+        std::size_t used_memory;
+        std::size_t allocation_count;
+    };
+
+public:
+    explicit thread_caching_allocator(allocator& backing)
+    : allocator(0)
+    , m_backing(backing)
+    , m_id(next_id()) {}
+
+    thread_caching_allocator(const thread_caching_allocator&) = delete;
+    thread_caching_allocator& operator=(const thread_caching_allocator&) = delete;
+
+    ~thread_caching_allocator() override {
+        std::lock_guard lock(m_mutex);
+        for (auto& cache : m_caches) {
+            collect_remote(*cache);
+            for (std::size_t c = 0; c < class_count; ++c) {
+                release_blocks(*cache, c, cache->bins[c].count);
+            }
+        }
+        update_counters();
+    }
+
+    void* allocate(std::size_t size, std::size_t align) override {
+        assert(size != 0 && align != 0);
+
+        if (size > max_size() || align > header_size) {
+            return allocate_direct(size, align);
+        }
+
+        auto c = class_index(size);
+        auto& cache = local_cache();
+        auto& b = cache.bins[c];
+        if (!b.head) {
+            if (collect_remote(cache)) {
+                std::lock_guard lock(m_mutex);
+                trim(cache);
+                update_counters();
+            }
+            if (!b.head && !refill(cache, c)) {
+                return nullptr;
+            }
+        }
+
+        auto block = std::exchange(b.head, b.head->next);
+        --b.count;
+        increment(cache.used_memory, class_size(c));
+        increment(cache.allocation_count, 1);
+
+        return block;
+    }
+
+    void deallocate(void* ptr) override {
+        assert(ptr);
+
+        auto h = header_of(ptr);
+        if (!h->owner) {
+            deallocate_direct(ptr);
+            return;
+        }
+
+        auto& cache = local_cache();
+        increment(cache.used_memory, -class_size(h->size_class));
+        increment(cache.allocation_count, -std::size_t(1));
+
+        auto block = static_cast<free_block*>(ptr);
+        if (h->owner == &cache) {
+            auto& b = cache.bins[h->size_class];
+            block->next = std::exchange(b.head, block);
+            if (++b.count > cache_capacity) {
+                std::lock_guard lock(m_mutex);
+                release_blocks(cache, h->size_class, cache_capacity / 2);
+                update_counters();
+            }
+        } else {
+            // hand the block back to its owner
+            auto& remote = h->owner->remote;
+            block->next = remote.load(std::memory_order_relaxed);
+            while (!remote.compare_exchange_weak(block->next, block, std::memory_order_release, std::memory_order_relaxed)) {}
+        }
+    }
+
+    /// Return the blocks cached by the calling thread to the backing allocator
+    /// and update the counters with the allocations of every thread
+    void flush() {
+        auto& cache = local_cache();
+        collect_remote(cache);
+        std::lock_guard lock(m_mutex);
+        for (std::size_t c = 0; c < class_count; ++c) {
+            release_blocks(cache, c, cache.bins[c].count);
+        }
+        update_counters();
+    }
+
+    /// Get the counters of the allocator, including the allocations of the
+    /// other threads
+    ///
+    /// \note It is safe to call this from multiple threads
+    statistics stats() const {
+        std::lock_guard lock(m_mutex);
+        return sum_counters();
+    }
+
+    /// Get the size of the largest allocation served from the caches
+    static constexpr std::size_t max_size() noexcept { return std::size_t(1) << (min_class_shift + class_count - 1); }
+
+private:
+    static constexpr std::size_t class_count = 12;
+    static constexpr std::size_t min_class_shift = 4;
+
+    struct thread_cache;
+
+    // stored right before every block
+    struct header {
+        // the cache the block belongs to, null if it bypasses the caches
+        thread_cache* owner;
+        std::uint32_t size_class;
+        // the distance of the block from the memory of the backing allocator
+        std::uint32_t offset;
+    };
+
+    static constexpr std::size_t header_size = 16;
+    static_assert(sizeof(header) == header_size);
+
+    // overlays the memory of a free block
+    struct free_block {
+        free_block* next;
+    };
+
+    struct bin {
+        free_block* head = nullptr;
+        std::size_t count = 0;
+    };
+
+    struct thread_cache {
+        std::array<bin, class_count> bins;
+        // blocks freed by other threads
+        std::atomic<free_block*> remote = ATOMIC_VAR_INIT(nullptr);
+        // only written by the thread of the cache, the frees of other
+        // threads are counted by their own cache, so these can wrap around
+        std::atomic<std::size_t> used_memory = ATOMIC_VAR_INIT(0);
+        std::atomic<std::size_t> allocation_count = ATOMIC_VAR_INIT(0);
+        // set when the thread of the cache exits
+        std::atomic<bool> is_orphaned = ATOMIC_VAR_INIT(false);
+        // the blocks taken from the backing allocator for the cache, only
+        // accessed with the lock held
+        std::size_t block_count = 0;
+    };
+
+    // the caches of a thread, shared with the allocators so they outlive
+    // each other
+    struct thread_caches {
+        std::vector<std::pair<std::uint64_t, std::shared_ptr<thread_cache>>> entries;
+        std::pair<std::uint64_t, thread_cache*> last {0, nullptr};
+
+        thread_caches() = default;
+
+        thread_caches(const thread_caches&) = delete;
+        thread_caches& operator=(const thread_caches&) = delete;
+
+        ~thread_caches() {
+            for (auto& entry : entries) {
+                entry.second->is_orphaned.store(true, std::memory_order_release);
+            }
+        }
+    };
+
+private:
+    static std::uint64_t next_id() {
+        static std::atomic<std::uint64_t> s_next_id = ATOMIC_VAR_INIT(1);
+        return s_next_id.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static std::size_t class_index(std::size_t size) noexcept {
+        std::size_t c = 0;
+        while (class_size(c) < size) {
+            ++c;
+        }
+        return c;
+    }
+
+    static constexpr std::size_t class_size(std::size_t c) noexcept { return std::size_t(1) << (min_class_shift + c); }
+
+    static void increment(std::atomic<std::size_t>& counter, std::size_t value) noexcept {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    static header* header_of(void* ptr) noexcept { return static_cast<header*>(sub(ptr, header_size)); }
+
+    // get the cache of the calling thread, creating it on first use
+    thread_cache& local_cache() {
+        // allocators are identified by a unique id, so a new allocator at the
+        // address of a destroyed one does not find its caches
+        thread_local thread_caches t_caches;
+        if (t_caches.last.first == m_id) {
+            return *t_caches.last.second;
+        }
+
+        for (auto& entry : t_caches.entries) {
+            if (entry.first == m_id) {
+                t_caches.last = {m_id, entry.second.get()};
+                return *entry.second;
+            }
+        }
+
+        auto cache = std::make_shared<thread_cache>();
+        {
+            std::lock_guard lock(m_mutex);
+            m_caches.push_back(cache);
+        }
+        t_caches.entries.emplace_back(m_id, cache);
+        t_caches.last = {m_id, cache.get()};
+        return *cache;
+    }
+
+    // move the blocks freed by other threads to the bins, returning true if a
+    // bin is over its capacity
+    bool collect_remote(thread_cache& cache) noexcept {
+        auto is_overflowing = false;
+        auto block = cache.remote.exchange(nullptr, std::memory_order_acquire);
+        while (block) {
+            auto& b = cache.bins[header_of(block)->size_class];
+            auto next = block->next;
+            block->next = std::exchange(b.head, block);
+            is_overflowing |= ++b.count > cache_capacity;
+            block = next;
+        }
+        return is_overflowing;
+    }
+
+    // return the blocks of the bins over their capacity to the backing
+    // allocator, the lock must be held
+    void trim(thread_cache& cache) {
+        for (std::size_t c = 0; c < class_count; ++c) {
+            auto count = cache.bins[c].count;
+            if (count > cache_capacity) {
+                release_blocks(cache, c, count - cache_capacity / 2);
+            }
+        }
+    }
+
+    // allocate half a cache of blocks from the backing allocator
+    bool refill(thread_cache& cache, std::size_t c) {
+        std::lock_guard lock(m_mutex);
+        auto& b = cache.bins[c];
+        for (std::size_t i = 0; i < cache_capacity / 2; ++i) {
+            auto ptr = allocate_block(class_size(c), header_size);
+            if (!ptr) {
+                break;
+            }
+            header_of(ptr)->owner = &cache;
+            header_of(ptr)->size_class = static_cast<std::uint32_t>(c);
+            b.head = new (ptr) free_block {b.head};
+            ++b.count;
+            ++cache.block_count;
+        }
+        update_counters();
+        return b.head != nullptr;
+    }
+
+    // allocate a block with room for the header from the backing allocator,
+    // the lock must be held
+    void* allocate_block(std::size_t size, std::size_t align) {
+        // only the alignment of the header is requested, as not every
+        // allocator supports larger ones, the block is aligned by hand
+        auto used = m_backing.used_memory();
+        auto raw = m_backing.allocate(size + header_size + align - alignof(header), alignof(header));
+        if (!raw) {
+            return nullptr;
+        }
+        m_backing_used += m_backing.used_memory() - used;
+        auto ptr = memory::align(add(raw, header_size), align);
+        new (header_of(ptr)) header {nullptr, class_count, static_cast<std::uint32_t>(as_uint(ptr) - as_uint(raw))};
+        return ptr;
+    }
+
+    // return blocks of the class to the backing allocator, the lock must be
+    // held
+    void release_blocks(thread_cache& cache, std::size_t c, std::size_t count) {
+        auto& b = cache.bins[c];
+        for (; count > 0 && b.head; --count) {
+            auto block = std::exchange(b.head, b.head->next);
+            --b.count;
+            --cache.block_count;
+            deallocate_block(block);
+        }
+    }
+
+    // release the blocks of the caches of exited threads, dropping the caches
+    // none of the blocks refer to anymore, the lock must be held
+    void collect_orphans() {
+        auto it = std::remove_if(m_caches.begin(), m_caches.end(), [this](const std::shared_ptr<thread_cache>& cache) {
+            if (!cache->is_orphaned.load(std::memory_order_acquire)) {
+                return false;
+            }
+            collect_remote(*cache);
+            for (std::size_t c = 0; c < class_count; ++c) {
+                release_blocks(*cache, c, cache->bins[c].count);
+            }
+            if (cache->block_count != 0) {
+                return false;
+            }
+            m_orphaned_used += cache->used_memory.load(std::memory_order_relaxed);
+            m_orphaned_count += cache->allocation_count.load(std::memory_order_relaxed);
+            return true;
+        });
+        m_caches.erase(it, m_caches.end());
+    }
+
+    // sum the counters of the caches, the lock must be held
+    statistics sum_counters() const noexcept {
+        statistics result {m_direct_used + m_orphaned_used, m_direct_count + m_orphaned_count};
+        for (auto& cache : m_caches) {
+            result.used_memory += cache->used_memory.load(std::memory_order_relaxed);
+            result.allocation_count += cache->allocation_count.load(std::memory_order_relaxed);
+        }
+        return result;
+    }
+
+    // the caches are scanned for the sum anyway, so the orphaned ones are
+    // collected too, the lock must be held
+    void update_counters() {
+        collect_orphans();
+        auto counters = sum_counters();
+        m_used_memory = counters.used_memory;
+        m_allocation_count = counters.allocation_count;
+    }
+
+    // return a block to the backing allocator, the lock must be held
+    void deallocate_block(void* ptr) {
+        auto used = m_backing.used_memory();
+        m_backing.deallocate(sub(ptr, header_of(ptr)->offset));
+        m_backing_used -= used - m_backing.used_memory();
+    }
+
+    void* allocate_direct(std::size_t size, std::size_t align) {
+        std::lock_guard lock(m_mutex);
+        auto used = m_backing_used;
+        auto ptr = allocate_block(size, align > header_size ? align : header_size);
+        if (ptr) {
+            m_direct_used += m_backing_used - used;
+            ++m_direct_count;
+            update_counters();
+        }
+        return ptr;
+    }
+
+    void deallocate_direct(void* ptr) {
+        std::lock_guard lock(m_mutex);
+        auto used = m_backing_used;
+        deallocate_block(ptr);
+        m_direct_used -= used - m_backing_used;
+        --m_direct_count;
+        update_counters();
+    }
+
+private:
+    allocator& m_backing;
+    std::uint64_t m_id;
+    mutable std::mutex m_mutex;
+    std::vector<std::shared_ptr<thread_cache>> m_caches;
+    // the memory taken from the backing allocator
+    std::size_t m_backing_used = 0;
+    // the allocations bypassing the caches
+    std::size_t m_direct_used = 0;
+    std::size_t m_direct_count = 0;
+    // the counters of the dropped caches
+    std::size_t m_orphaned_used = 0;
+    std::size_t m_orphaned_count = 0;
+};
+
+} // namespace memory
+
+// bring symbols into parent namespace
+
+using memory::thread_caching_allocator;
+
+} // namespace shard
@@ -0,0 +1,291 @@
+// Copyright (c) 2026 Miklos Molnar. All rights reserved.
+
+#pragma once
+
+#include "shard/alloc/allocator.hpp"
+
+#include <shard/memory/utils.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace shard {
+namespace memory {
+
+/// General purpose allocator with O(1) allocation and deallocation
+///
+/// The free blocks are kept in lists segregated by size on two levels: the
+/// first level splits the sizes into powers of two, the second level splits
+/// each power of two into linear ranges. Bitmaps of the non-empty lists find a
+/// large enough block with two bit scans. Every block also knows its physical
+/// neighbours, so freed blocks are merged with the adjacent free ones
+/// immediately.
+///
+/// \see "TLSF: a New Dynamic Memory Allocator for Real-Time Systems"
+///      (M. Masmano, I. Ripoll, A. Crespo, J. Real)
+class tlsf_allocator : public allocator {
+public:
+    tlsf_allocator(void* data, std::size_t size)
+    : allocator(size) {
+        auto padding = get_padding(data, granularity);
+        assert(size > padding + min_block_size + header_size);
+        auto usable = (size - padding - header_size) & ~(granularity - 1);
+        assert(usable < (std::size_t(1) << (fl_shift + fl_count - 1)));
+
+        // one free block spanning the whole memory, followed by an empty used
+        // block, so that every block has a physical successor
+        auto first = reinterpret_cast<block*>(add(data, padding));
+        first->prev_phys = nullptr;
+        first->size = usable;
+        auto sentinel = next_phys(first);
+        sentinel->prev_phys = first;
+        sentinel->size = 0;
+        insert_free(first);
+    }
+
+    tlsf_allocator(const tlsf_allocator&) = delete;
+    tlsf_allocator& operator=(const tlsf_allocator&) = delete;
+
+    void* allocate(std::size_t size, std::size_t align) override {
+        assert(size != 0 && align != 0);
+
+        auto block_size = round_up(size + header_size);
+        block_size = block_size < min_block_size ? min_block_size : block_size;
+        // over-aligned blocks need room for splitting off the padding
+        auto search_size = align > granularity ? block_size + align + min_block_size : block_size;
+
+        auto b = find_free(search_size);
+        if (!b) {
+            return nullptr;
+        }
+        remove_free(b);
+
+        if (align > granularity) {
+            auto payload = as_uint(b) + header_size;
+            auto gap = get_padding(as_ptr(payload), align);
+            // the padding in front becomes a free block of its own
+            while (gap != 0 && gap < min_block_size) {
+                gap += align;
+            }
+            if (gap != 0) {
+                // free blocks never have free neighbours, so the padding
+                // does not need to be merged
+                auto front = b;
+                b = split(front, gap);
+                insert_free(front);
+            }
+        }
+
+        if (size_of(b) >= block_size + min_block_size) {
+            insert_free(split(b, block_size));
+        }
+        set_used(b);
+
+        auto ptr = add(b, header_size);
+        assert(is_aligned(ptr, align));
+
+        m_used_memory += size_of(b);
+        ++m_allocation_count;
+
+        return ptr;
+    }
+
+    void deallocate(void* ptr) override {
+        assert(ptr);
+
+        auto b = reinterpret_cast<block*>(sub(ptr, header_size));
+        assert(!is_free(b));
+
+        m_used_memory -= size_of(b);
+        --m_allocation_count;
+
+        set_free(b);
+        b = merge_prev(b);
+        b = merge_next(b);
+        insert_free(b);
+    }
+
+private:
+    struct block {
+        // the block right before this one in memory
+        block* prev_phys;
+        // the size including the header, the lowest bit marks free blocks
+        std::size_t size;
+        // links in the list of free blocks of the same size range, only valid
+        // in free blocks
+        block* next_free;
+        block* prev_free;
+    };
+
+    // every block is a multiple of the granularity, so the payload is aligned
+    // to it
+    static constexpr std::size_t granularity = 16;
+    static constexpr std::size_t header_size = 2 * sizeof(void*);
+    static constexpr std::size_t min_block_size = sizeof(block) < granularity ? granularity : sizeof(block);
+
+    // each power of two is split into 16 ranges, the sizes below 256 are
+    // split linearly into 16 byte ranges
+    static constexpr std::size_t sl_shift = 4;
+    static constexpr std::size_t sl_count = std::size_t(1) << sl_shift;
+    static constexpr std::size_t fl_shift = sl_shift + 4;
+    static constexpr std::size_t fl_count = 32;
+
+    static constexpr std::size_t free_bit = 1;
+
+private:
+    static std::size_t round_up(std::size_t size) noexcept { return (size + granularity - 1) & ~(granularity - 1); }
+
+    static std::size_t size_of(const block* b) noexcept { return b->size & ~free_bit; }
+
+    static bool is_free(const block* b) noexcept { return b->size & free_bit; }
+
+    static void set_free(block* b) noexcept { b->size |= free_bit; }
+
+    static void set_used(block* b) noexcept { b->size &= ~free_bit; }
+
+    static block* next_phys(block* b) noexcept { return reinterpret_cast<block*>(add(b, size_of(b))); }
+
+    // index of the lowest set bit, the value must not be 0
+    static std::size_t find_first_set(std::uint32_t value) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<std::size_t>(__builtin_ctz(value));
+#else
+        std::size_t i = 0;
+        for (; (value & 1) == 0; value >>= 1) {
+            ++i;
+        }
+        return i;
+#endif
+    }
+
+    // index of the highest set bit, the value must not be 0
+    static std::size_t find_last_set(std::size_t value) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        return sizeof(unsigned long long) * 8 - 1 - static_cast<std::size_t>(__builtin_clzll(value));
+#else
+        std::size_t i = 0;
+        for (; value > 1; value >>= 1) {
+            ++i;
+        }
+        return i;
+#endif
+    }
+
+    // get the lists the size belongs to
+    static void mapping(std::size_t size, std::size_t& fl, std::size_t& sl) noexcept {
+        if (size < (std::size_t(1) << fl_shift)) {
+            fl = 0;
+            sl = size / granularity;
+        } else {
+            auto msb = find_last_set(size);
+            fl = msb - fl_shift + 1;
+            sl = (size >> (msb - sl_shift)) ^ sl_count;
+        }
+    }
+
+    // find a free block of at least the size, rounding the size up to the
+    // next list so that any block in it is large enough
+    block* find_free(std::size_t size) noexcept {
+        if (size >= (std::size_t(1) << fl_shift)) {
+            size += (std::size_t(1) << (find_last_set(size) - sl_shift)) - 1;
+        }
+        std::size_t fl, sl;
+        mapping(size, fl, sl);
+        if (fl >= fl_count) {
+            return nullptr;
+        }
+
+        auto sl_map = m_sl_bitmap[fl] & (~std::uint32_t(0) << sl);
+        if (sl_map == 0) {
+            // take the smallest list of a larger power of two
+            auto fl_map = fl + 1 < fl_count ? m_fl_bitmap & (~std::uint32_t(0) << (fl + 1)) : 0;
+            if (fl_map == 0) {
+                return nullptr;
+            }
+            fl = find_first_set(fl_map);
+            sl_map = m_sl_bitmap[fl];
+        }
+        return m_free[fl][find_first_set(sl_map)];
+    }
+
+    void insert_free(block* b) noexcept {
+        std::size_t fl, sl;
+        mapping(size_of(b), fl, sl);
+        auto& head = m_free[fl][sl];
+        set_free(b);
+        b->prev_free = nullptr;
+        b->next_free = head;
+        if (head) {
+            head->prev_free = b;
+        }
+        head = b;
+        m_fl_bitmap |= std::uint32_t(1) << fl;
+        m_sl_bitmap[fl] |= std::uint32_t(1) << sl;
+    }
+
+    void remove_free(block* b) noexcept {
+        std::size_t fl, sl;
+        mapping(size_of(b), fl, sl);
+        if (b->prev_free) {
+            b->prev_free->next_free = b->next_free;
+        } else {
+            m_free[fl][sl] = b->next_free;
+            if (!b->next_free) {
+                m_sl_bitmap[fl] &= ~(std::uint32_t(1) << sl);
+                if (m_sl_bitmap[fl] == 0) {
+                    m_fl_bitmap &= ~(std::uint32_t(1) << fl);
+                }
+            }
+        }
+        if (b->next_free) {
+            b->next_free->prev_free = b->prev_free;
+        }
+    }
+
+    // split the block after 'size' bytes, returning the remainder
+    static block* split(block* b, std::size_t size) noexcept {
+        auto rest = reinterpret_cast<block*>(add(b, size));
+        rest->size = size_of(b) - size;
+        rest->prev_phys = b;
+        next_phys(rest)->prev_phys = rest;
+        b->size = size | (b->size & free_bit);
+        return rest;
+    }
+
+    // merge the free block with its predecessor if it is free as well
+    block* merge_prev(block* b) noexcept {
+        auto prev = b->prev_phys;
+        if (!prev || !is_free(prev)) {
+            return b;
+        }
+        remove_free(prev);
+        prev->size += size_of(b);
+        next_phys(prev)->prev_phys = prev;
+        return prev;
+    }
+
+    // merge the free block with its successor if it is free as well
+    block* merge_next(block* b) noexcept {
+        auto next = next_phys(b);
+        if (!is_free(next)) {
+            return b;
+        }
+        remove_free(next);
+        b->size += size_of(next);
+        next_phys(b)->prev_phys = b;
+        return b;
+    }
+
+private:
+    std::uint32_t m_fl_bitmap = 0;
+    std::uint32_t m_sl_bitmap[fl_count] = {};
+    block* m_free[fl_count][sl_count] = {};
+};
+
+} // namespace memory
+
+// bring symbols into parent namespace
+
+using memory::tlsf_allocator;
+
+} // namespace shard
@@ -2,8 +2,25 @@
 
 #pragma once
 
+#include "shard/concurrency/adaptive_mutex.hpp"
+#include "shard/concurrency/barrier.hpp"
 #include "shard/concurrency/channel.hpp"
+#include "shard/concurrency/coroutine.hpp"
+#include "shard/concurrency/latch.hpp"
+#include "shard/concurrency/latency_histogram.hpp"
+#include "shard/concurrency/lightweight_semaphore.hpp"
 #include "shard/concurrency/lock_traits.hpp"
+#include "shard/concurrency/mpmc_queue.hpp"
 #include "shard/concurrency/mpsc_queue.hpp"
 #include "shard/concurrency/null_mutex.hpp"
+#include "shard/concurrency/rate_limiter.hpp"
+#include "shard/concurrency/rcu_thread_safe.hpp"
+#include "shard/concurrency/rw_spin_mutex.hpp"
+#include "shard/concurrency/select.hpp"
+#include "shard/concurrency/seq_value.hpp"
+#include "shard/concurrency/sharded_thread_safe.hpp"
+#include "shard/concurrency/snapshot_value.hpp"
+#include "shard/concurrency/spin_mutex.hpp"
+#include "shard/concurrency/spsc_queue.hpp"
 #include "shard/concurrency/thread_safe.hpp"
+#include "shard/concurrency/unbounded_mpsc_queue.hpp"
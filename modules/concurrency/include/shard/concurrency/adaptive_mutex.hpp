@@ -0,0 +1,68 @@
+// Copyright (c) 2026 Miklos Molnar. All rights reserved.
+
+#pragma once
+
+#include "shard/concurrency/detail/backoff.hpp"
+#include "shard/concurrency/futex.hpp"
+
+#include <shard/utility/non_copyable.hpp>
+
+#include <atomic>
+#include <cstdint>
+
+namespace shard {
+namespace concurrency {
+
+/// Mutex that spins for a while before blocking
+///
+/// Short critical sections are waited out in user space, the thread only
+/// blocks on a futex if the lock is still held after spinning. Unlocking only
+/// makes a system call when there are blocked threads.
+///
+/// \see "Futexes Are Tricky" (Ulrich Drepper)
+class adaptive_mutex : private utility::non_copyable {
+public:
+    adaptive_mutex() = default;
+
+    adaptive_mutex(adaptive_mutex&&) = delete;
+    adaptive_mutex& operator=(adaptive_mutex&&) = delete;
+
+    void lock() {
+        if (detail::spin_until([this] { return m_state.load(std::memory_order_relaxed) == unlocked && try_lock(); })) {
+            return;
+        }
+        // mark the lock contended, so the owner wakes a waiter on unlock
+        auto state = m_state.exchange(contended, std::memory_order_acquire);
+        while (state != unlocked) {
+            futex_wait(m_state, contended);
+            state = m_state.exchange(contended, std::memory_order_acquire);
+        }
+    }
+
+    void unlock() {
+        if (m_state.exchange(unlocked, std::memory_order_release) == contended) {
+            futex_wake_one(m_state);
+        }
+    }
+
+    bool try_lock() noexcept {
+        auto state = unlocked;
+        return m_state.compare_exchange_strong(state, locked, std::memory_order_acquire, std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr std::uint32_t unlocked = 0;
+    static constexpr std::uint32_t locked = 1;
+    static constexpr std::uint32_t contended = 2;
+
+private:
+    std::atomic<std::uint32_t> m_state = ATOMIC_VAR_INIT(unlocked);
+};
+
+} // namespace concurrency
+
+// bring symbols into parent namespace
+
+using concurrency::adaptive_mutex;
+
+} // namespace shard
@@ -0,0 +1,79 @@
+// Copyright (c) 2026 Miklos Molnar. All rights reserved.
+
+#pragma once
+
+#include "shard/concurrency/detail/backoff.hpp"
+#include "shard/concurrency/futex.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+namespace shard {
+namespace concurrency {
+
+/// Reusable synchronization point for a group of threads
+///
+/// The threads arriving early block on the phase number with a futex, the
+/// last thread to arrive starts the next phase and wakes them.
+class barrier {
+public:
+    /// Create a barrier for the given number of threads
+    explicit barrier(std::ptrdiff_t count)
+    : m_expected(static_cast<std::uint32_t>(count))
+    , m_remaining(static_cast<std::uint32_t>(count)) {
+        assert(count > 0);
+    }
+
+    barrier(const barrier&) = delete;
+    barrier& operator=(const barrier&) = delete;
+
+    /// Arrive at the barrier and block until every thread of the current
+    /// phase has arrived
+    void arrive_and_wait() {
+        auto phase = m_phase.load(std::memory_order_acquire);
+        if (arrive()) {
+            return;
+        }
+        auto is_next_phase = [this, phase] { return m_phase.load(std::memory_order_acquire) != phase; };
+        if (detail::spin_until(is_next_phase)) {
+            return;
+        }
+        while (!is_next_phase()) {
+            futex_wait(m_phase, phase);
+        }
+    }
+
+    /// Arrive at the barrier and remove the calling thread from the following
+    /// phases without waiting
+    void arrive_and_drop() {
+        m_expected.fetch_sub(1, std::memory_order_relaxed);
+        arrive();
+    }
+
+private:
+    // count the arrival and start the next phase if it was the last one
+    bool arrive() {
+        if (m_remaining.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+            return false;
+        }
+        m_remaining.store(m_expected.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        m_phase.fetch_add(1, std::memory_order_release);
+        futex_wake_all(m_phase);
+        return true;
+    }
+
+private:
+    std::atomic<std::uint32_t> m_expected;
+    std::atomic<std::uint32_t> m_remaining;
+    std::atomic<std::uint32_t> m_phase = ATOMIC_VAR_INIT(0);
+};
+
+} // namespace concurrency
+
+// bring symbols into parent namespace
+
+using concurrency::barrier;
+
+} // namespace shard
@@ -0,0 +1,26 @@
+// Copyright (c) 2026 Miklos Molnar. All rights reserved.
+
+#pragma once
+
+#include <cstddef>
+
+namespace shard {
+namespace concurrency {
+
+/// The assumed size of a cache line
+///
+/// Data written by different threads should be at least this far apart to
+/// avoid false sharing.
+#if defined(__APPLE__) && defined(__aarch64__)
+inline constexpr std::size_t cache_line_size = 128;
+#else
+inline constexpr std::size_t cache_line_size = 64;
+#endif
+
+} // namespace concurrency
+
+// bring symbols into parent namespace
+
+using concurrency::cache_line_size;
+
+} // namespace shard
@@ -2,8 +2,16 @@
 
 #pragma once
 
+#include "shard/concurrency/detail/async_pop_waiter.hpp"
+#include "shard/concurrency/detail/coroutine_support.hpp"
+#include "shard/concurrency/detail/select_waiter.hpp"
+
 #include <atomic>
+#include <cassert>
+#include <chrono>
 #include <condition_variable>
+#include <cstdint>
+#include <limits>
 #include <mutex>
 #include <optional>
 #include <queue>
@@ -11,61 +19,133 @@
 
 namespace shard {
 namespace concurrency {
+namespace detail {
+
+class selector;
+
+} // namespace detail
+
+/// Counters of a channel
+struct channel_metrics {
+    /// The number of items added
+    std::uint64_t pushed = 0;
+    /// The number of items removed
+    std::uint64_t popped = 0;
+    /// The number of items on the channel
+    std::size_t size = 0;
+    /// The number of producers blocked on the full channel
+    std::size_t waiting_producers = 0;
+};
 
 template <typename T>
 class channel {
+    friend class detail::selector;
+
 public:
     using value_type = T;
     using size_type = std::size_t;
 
 public:
-    /// Default constructor
+    /// Create an unbounded channel
     channel() = default;
 
+    /// Create a channel holding at most 'capacity' items
+    ///
+    /// \note Pushing to a full channel blocks the calling thread until an item
+    ///       is popped.
+    explicit channel(size_type capacity)
+    : m_capacity(capacity) {
+        assert(capacity > 0);
+    }
+
     /// Destructor that closes the channel and notifies all waiting threads
     ~channel() { close(); }
 
     /// Add a new item to the channel by copying it
-    void push(const value_type& value) {
-        if (!m_open) {
-            return;
-        }
-        // put the value on the queue
-        {
-            std::lock_guard lock(m_mutex);
-            m_queue.push(value);
-        }
-        // lock released before notifying
-        m_cv.notify_one();
-    }
+    ///
+    /// \note If the channel is full, the calling thread is blocked until there
+    /// is room for the item or the channel is closed.
+    ///
+    /// \return true if the item was added, false if the channel was closed
+    bool push(const value_type& value) { return emplace(value); }
 
     /// Add a new item to the channel by moving it
-    void push(value_type&& value) {
-        if (!m_open) {
-            return;
-        }
-        // put the value on the queue
-        {
-            std::lock_guard lock(m_mutex);
-            m_queue.push(std::move(value));
-        }
-        // lock released before notifying
-        m_cv.notify_one();
-    }
+    ///
+    /// \note If the channel is full, the calling thread is blocked until there
+    /// is room for the item or the channel is closed.
+    ///
+    /// \return true if the item was added, false if the channel was closed
+    bool push(value_type&& value) { return emplace(std::move(value)); }
 
     /// Add a new item to the channel by creating it in-place
+    ///
+    /// \note If the channel is full, the calling thread is blocked until there
+    /// is room for the item or the channel is closed.
+    ///
+    /// \return true if the item was added, false if the channel was closed
     template <typename... Args>
-    void emplace(Args&&... args) {
+    bool emplace(Args&&... args) {
         if (!m_open) {
-            return;
+            return false;
         }
         // create the value in-place on the queue
+        detail::async_pop_waiter<value_type>* waiter = nullptr;
         {
-            std::lock_guard lock(m_mutex);
-            m_queue.emplace(std::forward<Args>(args)...);
+            std::unique_lock lock(m_mutex);
+            if (!wait_not_full(lock)) {
+                return false;
+            }
+            if ((waiter = take_async_waiter())) {
+                waiter->value.emplace(std::forward<Args>(args)...);
+            } else {
+                m_queue.emplace(std::forward<Args>(args)...);
+                notify_waiters();
+            }
+            count_pushed(waiter != nullptr);
         }
         // lock released before notifying
-        m_cv.notify_one();
+        notify_pushed(waiter);
+        return true;
+    }
+
+    /// Add a new item to the channel by copying it
+    ///
+    /// \note The calling thread is *NOT* blocked.
+    ///
+    /// \return true if the item was added, false if the channel was closed or
+    /// full
+    bool try_push(const value_type& value) { return try_push_for(value, std::chrono::seconds(0)); }
+
+    /// Add a new item to the channel by moving it
+    ///
+    /// \note The calling thread is *NOT* blocked. The item is only moved from
+    /// if it was added.
+    ///
+    /// \return true if the item was added, false if the channel was closed or
+    /// full
+    bool try_push(value_type&& value) { return try_push_for(std::move(value), std::chrono::seconds(0)); }
+
+    /// Add a new item to the channel by copying it
+    ///
+    /// \note If the channel is full, the calling thread is blocked until there
+    /// is room for the item, the channel is closed or the timeout has elapsed.
+    ///
+    /// \return true if the item was added, false otherwise
+    template <typename Rep, typename Period>
+    bool try_push_for(const value_type& value, const std::chrono::duration<Rep, Period>& timeout) {
+        return push_until(value, std::chrono::steady_clock::now() + timeout);
+    }
+
+    /// Add a new item to the channel by moving it
+    ///
+    /// \note If the channel is full, the calling thread is blocked until there
+    /// is room for the item, the channel is closed or the timeout has elapsed.
+    /// The item is only moved from if it was added.
+    ///
+    /// \return true if the item was added, false otherwise
+    template <typename Rep, typename Period>
+    bool try_push_for(value_type&& value, const std::chrono::duration<Rep, Period>& timeout) {
+        return push_until(std::move(value), std::chrono::steady_clock::now() + timeout);
     }
 
     /// Pop and retrieve the next value from the channel
@@ -77,12 +157,16 @@ public:
     /// \return true if a value was retrieved, false if the channel was closed
     /// or if the queue is empty
     bool try_pop(value_type& out) {
-        std::lock_guard lock(m_mutex);
-        if (!m_open || m_queue.empty()) {
-            return false;
+        {
+            std::lock_guard lock(m_mutex);
+            if (!m_open || m_queue.empty()) {
+                return false;
+            }
+            out = std::move(m_queue.front());
+            m_queue.pop();
+            count_popped(1);
         }
-        out = std::move(m_queue.front());
-        m_queue.pop();
+        notify_not_full(1);
         return true;
     }
 
@@ -93,12 +177,17 @@ public:
     /// \return An optional value with the result if a value was retrieved from
     /// the queue, nullopt otherwise
     std::optional<T> try_pop() {
-        std::lock_guard lock(m_mutex);
-        if (!m_open || m_queue.empty()) {
-            return std::nullopt;
+        std::optional<T> result;
+        {
+            std::lock_guard lock(m_mutex);
+            if (!m_open || m_queue.empty()) {
+                return std::nullopt;
+            }
+            result.emplace(std::move(m_queue.front()));
+            m_queue.pop();
+            count_popped(1);
         }
-        auto result = std::make_optional(std::move(m_queue.front()));
-        m_queue.pop();
+        notify_not_full(1);
         return result;
     }
 
@@ -111,14 +200,18 @@ public:
     ///
     /// \return true if a value was retrieved, false if the channel was closed
     bool pop(value_type& out) {
-        std::unique_lock lock(m_mutex);
-        // unblock if closed or there's something new on the queue
-        m_cv.wait(lock, [this] { return !m_open || !m_queue.empty(); });
-        if (!m_open) {
-            return false;
+        {
+            std::unique_lock lock(m_mutex);
+            // unblock if closed or there's something new on the queue
+            m_cv.wait(lock, [this] { return !m_open || !m_queue.empty(); });
+            if (!m_open) {
+                return false;
+            }
+            out = std::move(m_queue.front());
+            m_queue.pop();
+            count_popped(1);
         }
-        out = std::move(m_queue.front());
-        m_queue.pop();
+        notify_not_full(1);
         return true;
     }
 
@@ -130,29 +223,142 @@ public:
     /// \return An optional value with the result if a value was retrieved from
     /// the queue, nullopt otherwise
     std::optional<T> pop() {
-        std::unique_lock lock(m_mutex);
-        // unblock if closed or there's something new on the queue
-        m_cv.wait(lock, [this] { return !m_open || !m_queue.empty(); });
-        if (!m_open) {
-            return std::nullopt;
+        std::optional<T> result;
+        {
+            std::unique_lock lock(m_mutex);
+            // unblock if closed or there's something new on the queue
+            m_cv.wait(lock, [this] { return !m_open || !m_queue.empty(); });
+            if (!m_open) {
+                return std::nullopt;
+            }
+            result.emplace(std::move(m_queue.front()));
+            m_queue.pop();
+            count_popped(1);
+        }
+        notify_not_full(1);
+        return result;
+    }
+
+    /// Pop and retrieve the next value from the channel
+    ///
+    /// \note If the queue is empty, the calling thread is blocked until there
+    /// is an item on the queue, the channel is closed or the timeout has
+    /// elapsed.
+    ///
+    /// \param out The reference to be assigned the value
+    ///
+    /// \return true if a value was retrieved, false otherwise
+    template <typename Rep, typename Period>
+    bool pop_for(value_type& out, const std::chrono::duration<Rep, Period>& timeout) {
+        {
+            std::unique_lock lock(m_mutex);
+            if (!wait_not_empty_for(lock, timeout)) {
+                return false;
+            }
+            out = std::move(m_queue.front());
+            m_queue.pop();
+            count_popped(1);
+        }
+        notify_not_full(1);
+        return true;
+    }
+
+    /// Pop and retrieve the next value from the channel
+    ///
+    /// \note If the queue is empty, the calling thread is blocked until there
+    /// is an item on the queue, the channel is closed or the timeout has
+    /// elapsed.
+    ///
+    /// \return An optional value with the result if a value was retrieved from
+    /// the queue, nullopt otherwise
+    template <typename Rep, typename Period>
+    std::optional<T> pop_for(const std::chrono::duration<Rep, Period>& timeout) {
+        std::optional<T> result;
+        {
+            std::unique_lock lock(m_mutex);
+            if (!wait_not_empty_for(lock, timeout)) {
+                return std::nullopt;
+            }
+            result.emplace(std::move(m_queue.front()));
+            m_queue.pop();
+            count_popped(1);
         }
-        auto result = std::make_optional(std::move(m_queue.front()));
-        m_queue.pop();
+        notify_not_full(1);
         return result;
     }
 
+    /// Pop and retrieve up to 'max' values from the channel
+    ///
+    /// The values are taken with a single lock acquisition.
+    ///
+    /// \note If the queue is empty, the calling thread is blocked until there
+    /// is an item on the queue or the channel is closed.
+    ///
+    /// \return The number of values retrieved, 0 if the channel was closed
+    template <typename OutputIt>
+    size_type pop_batch(OutputIt out, size_type max) {
+        size_type count = 0;
+        {
+            std::unique_lock lock(m_mutex);
+            // unblock if closed or there's something new on the queue
+            m_cv.wait(lock, [this] { return !m_open || !m_queue.empty(); });
+            if (!m_open) {
+                return 0;
+            }
+            for (; count < max && !m_queue.empty(); ++count) {
+                *out = std::move(m_queue.front());
+                ++out;
+                m_queue.pop();
+            }
+            count_popped(count);
+        }
+        notify_not_full(count);
+        return count;
+    }
+
+#if SHARD_HAS_COROUTINES
+    /// Get an awaitable that pops and retrieves a value from the channel
+    ///
+    /// While the channel is empty the awaiting coroutine is suspended without
+    /// blocking its thread. It is resumed on the thread that adds the next
+    /// item or closes the channel.
+    ///
+    /// \return An awaitable resulting in the value, or std::nullopt if the
+    ///         channel was closed
+    [[nodiscard]] auto pop_async() noexcept { return pop_awaiter(*this); }
+#endif
+
     /// Get number of items on the channel
     size_type size() const {
         std::lock_guard lock(m_mutex);
         return m_queue.size();
     }
 
+    /// Get the maximum number of items on the channel
+    size_type capacity() const noexcept { return m_capacity; }
+
+    /// Get the counters of the channel
+    ///
+    /// \note The counters are read without taking the lock, so they are not
+    ///       necessarily consistent with each other.
+    channel_metrics metrics() const noexcept {
+        channel_metrics result;
+        result.pushed = m_pushed.load(std::memory_order_relaxed);
+        result.popped = m_popped.load(std::memory_order_relaxed);
+        result.size = m_size_hint.load(std::memory_order_relaxed);
+        result.waiting_producers = m_waiting_producers.load(std::memory_order_relaxed);
+        return result;
+    }
+
     /// Check if channel is empty
     bool is_empty() const {
         std::lock_guard lock(m_mutex);
         return m_queue.empty();
     }
 
+    /// Check if the number of items is limited
+    bool is_bounded() const noexcept { return m_capacity != unbounded; }
+
     /// Clear the channel, removing everything from the queue
     void clear() {
         {
@@ -160,9 +366,11 @@ public:
             while (!m_queue.empty()) {
                 m_queue.pop();
             }
+            m_size_hint.store(0, std::memory_order_relaxed);
         }
         // lock released before notifying
         m_cv.notify_all();
+        m_not_full_cv.notify_all();
     }
 
     /// Open the channel, notifying all waiting threads
@@ -185,7 +393,20 @@ public:
     void close() noexcept {
         auto was_open = m_open.exchange(false, std::memory_order_acq_rel);
         if (was_open) {
+            detail::async_pop_waiter<value_type>* waiters = nullptr;
+            {
+                // synchronize with the threads about to wait
+                std::lock_guard lock(m_mutex);
+                notify_waiters();
+                waiters = std::exchange(m_async_head, nullptr);
+                m_async_tail = nullptr;
+            }
             m_cv.notify_all();
+            m_not_full_cv.notify_all();
+            while (waiters) {
+                // completing the waiter might destroy it
+                std::exchange(waiters, waiters->next)->complete();
+            }
         }
     }
 
@@ -205,11 +426,197 @@ public:
         }
     }
 
+private:
+    static constexpr size_type unbounded = std::numeric_limits<size_type>::max();
+
+#if SHARD_HAS_COROUTINES
+    // suspends the awaiting coroutine until it is handed an item
+    class pop_awaiter final : public detail::async_pop_waiter<value_type> {
+    public:
+        explicit pop_awaiter(channel& c) noexcept
+        : m_channel(c) {}
+
+        bool await_ready() const noexcept { return false; }
+
+        bool await_suspend(std::coroutine_handle<> handle) {
+            m_handle = handle;
+            return m_channel.add_async_waiter(this);
+        }
+
+        std::optional<value_type> await_resume() { return std::move(this->value); }
+
+        void complete() override { m_handle.resume(); }
+
+    private:
+        channel& m_channel;
+        std::coroutine_handle<> m_handle;
+    };
+#endif
+
+private:
+    template <typename U, typename Clock, typename Duration>
+    bool push_until(U&& value, const std::chrono::time_point<Clock, Duration>& time) {
+        if (!m_open) {
+            return false;
+        }
+        detail::async_pop_waiter<value_type>* waiter = nullptr;
+        {
+            std::unique_lock lock(m_mutex);
+            if (!wait_not_full(lock, &time)) {
+                return false;
+            }
+            if ((waiter = take_async_waiter())) {
+                waiter->value.emplace(std::forward<U>(value));
+            } else {
+                m_queue.push(std::forward<U>(value));
+                notify_waiters();
+            }
+            count_pushed(waiter != nullptr);
+        }
+        // lock released before notifying
+        notify_pushed(waiter);
+        return true;
+    }
+
+    // wait until there is room for an item, or until the time point if given
+    template <typename TimePoint = std::chrono::steady_clock::time_point>
+    bool wait_not_full(std::unique_lock<std::mutex>& lock, const TimePoint* time = nullptr) {
+        auto is_ready = [this] { return !m_open || m_queue.size() < m_capacity; };
+        if (!is_ready()) {
+            ++m_waiting_producers;
+            if (time) {
+                m_not_full_cv.wait_until(lock, *time, is_ready);
+            } else {
+                m_not_full_cv.wait(lock, is_ready);
+            }
+            --m_waiting_producers;
+        }
+        return m_open && m_queue.size() < m_capacity;
+    }
+
+    template <typename Rep, typename Period>
+    bool wait_not_empty_for(std::unique_lock<std::mutex>& lock, const std::chrono::duration<Rep, Period>& timeout) {
+        // unblock if closed or there's something new on the queue
+        m_cv.wait_for(lock, timeout, [this] { return !m_open || !m_queue.empty(); });
+        return m_open && !m_queue.empty();
+    }
+
+    // register a waiter to be signaled when an item is added or the channel is
+    // closed
+    void add_waiter(detail::select_link* link) {
+        std::lock_guard lock(m_mutex);
+        link->prev = nullptr;
+        link->next = m_waiters;
+        if (m_waiters) {
+            m_waiters->prev = link;
+        }
+        m_waiters = link;
+    }
+
+    void remove_waiter(detail::select_link* link) {
+        std::lock_guard lock(m_mutex);
+        (link->prev ? link->prev->next : m_waiters) = link->next;
+        if (link->next) {
+            link->next->prev = link->prev;
+        }
+    }
+
+    // register a waiter to be handed the next item, unless an item is already
+    // available or the channel is closed
+    //
+    // returns false if the waiter was not registered, its value is set unless
+    // the channel is closed
+    bool add_async_waiter(detail::async_pop_waiter<value_type>* waiter) {
+        {
+            std::lock_guard lock(m_mutex);
+            if (m_open && m_queue.empty()) {
+                (m_async_tail ? m_async_tail->next : m_async_head) = waiter;
+                m_async_tail = waiter;
+                return true;
+            }
+            if (!m_open) {
+                return false;
+            }
+            waiter->value.emplace(std::move(m_queue.front()));
+            m_queue.pop();
+            count_popped(1);
+        }
+        notify_not_full(1);
+        return false;
+    }
+
+    // remove the first registered asynchronous waiter, must be called with the
+    // lock held
+    detail::async_pop_waiter<value_type>* take_async_waiter() noexcept {
+        auto waiter = m_async_head;
+        if (waiter) {
+            m_async_head = waiter->next;
+            if (!m_async_head) {
+                m_async_tail = nullptr;
+            }
+        }
+        return waiter;
+    }
+
+    // wake the consumer of the item that was added
+    void notify_pushed(detail::async_pop_waiter<value_type>* waiter) {
+        if (waiter) {
+            waiter->complete();
+        } else {
+            m_cv.notify_one();
+        }
+    }
+
+    // update the counters after an item was added, must be called with the
+    // lock held
+    void count_pushed(bool is_handed_over) noexcept {
+        m_pushed.store(m_pushed.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        count_popped(is_handed_over ? 1 : 0);
+    }
+
+    // update the counters after items were removed, must be called with the
+    // lock held
+    void count_popped(size_type count) noexcept {
+        m_popped.store(m_popped.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+        m_size_hint.store(m_queue.size(), std::memory_order_relaxed);
+    }
+
+    // signal the registered waiters, must be called with the lock held
+    void notify_waiters() {
+        for (auto link = m_waiters; link; link = link->next) {
+            link->waiter->notify();
+        }
+    }
+
+    // wake the producers blocked on a full channel after 'count' items were
+    // popped
+    void notify_not_full(size_type count) {
+        if (!is_bounded() || count == 0 || m_waiting_producers.load(std::memory_order_relaxed) == 0) {
+            return;
+        }
+        if (count == 1) {
+            m_not_full_cv.notify_one();
+        } else {
+            m_not_full_cv.notify_all();
+        }
+    }
+
 private:
     std::queue<value_type> m_queue;
+    size_type m_capacity = unbounded;
     mutable std::mutex m_mutex;
     std::condition_variable m_cv;
+    std::condition_variable m_not_full_cv;
+    std::atomic<size_type> m_waiting_producers = ATOMIC_VAR_INIT(0);
+    detail::select_link* m_waiters = nullptr;
+    detail::async_pop_waiter<value_type>* m_async_head = nullptr;
+    detail::async_pop_waiter<value_type>* m_async_tail = nullptr;
     std::atomic<bool> m_open = ATOMIC_VAR_INIT(true);
+
+    // counters readable without the lock
+    std::atomic<std::uint64_t> m_pushed = ATOMIC_VAR_INIT(0);
+    std::atomic<std::uint64_t> m_popped = ATOMIC_VAR_INIT(0);
+    std::atomic<size_type> m_size_hint = ATOMIC_VAR_INIT(0);
 };
 
 } // namespace concurrency
@@ -217,5 +624,6 @@ private:
 // bring symbols into parent namespace
 
 using concurrency::channel;
+using concurrency::channel_metrics;
 
 } // namespace shard
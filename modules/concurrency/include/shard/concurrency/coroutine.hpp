@@ -0,0 +1,387 @@
+// Copyright (c) 2026 Miklos Molnar. All rights reserved.
+
+#pragma once
+
+#include "shard/concurrency/detail/coroutine_support.hpp"
+
+#if SHARD_HAS_COROUTINES
+
+#include "shard/concurrency/latch.hpp"
+#include "shard/concurrency/thread_pool.hpp"
+
+#include <cassert>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace shard {
+namespace concurrency {
+
+template <typename T = void>
+class task;
+
+namespace detail {
+
+// state shared by the promises of every task type
+class task_promise_base {
+public:
+    // transfer the execution to the awaiting coroutine once done
+    struct final_awaiter {
+        bool await_ready() const noexcept { return false; }
+
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+            return handle.promise().continuation();
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+public:
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+
+    final_awaiter final_suspend() const noexcept { return {}; }
+
+    void unhandled_exception() noexcept { m_exception = std::current_exception(); }
+
+    std::coroutine_handle<> continuation() const noexcept { return m_continuation; }
+
+    void set_continuation(std::coroutine_handle<> handle) noexcept { m_continuation = handle; }
+
+protected:
+    void rethrow_if_exception() {
+        if (m_exception) {
+            std::rethrow_exception(m_exception);
+        }
+    }
+
+private:
+    std::coroutine_handle<> m_continuation = std::noop_coroutine();
+    std::exception_ptr m_exception;
+};
+
+template <typename T>
+class task_promise : public task_promise_base {
+public:
+    task<T> get_return_object() noexcept;
+
+    template <typename U>
+    void return_value(U&& value) {
+        m_value.emplace(std::forward<U>(value));
+    }
+
+    T result() {
+        rethrow_if_exception();
+        return std::move(*m_value);
+    }
+
+private:
+    std::optional<T> m_value;
+};
+
+template <>
+class task_promise<void> : public task_promise_base {
+public:
+    task<void> get_return_object() noexcept;
+
+    void return_void() noexcept {}
+
+    void result() { rethrow_if_exception(); }
+};
+
+} // namespace detail
+
+/// Lazily started coroutine producing a value
+///
+/// The coroutine starts when the task is awaited and resumes the awaiting
+/// coroutine once it is done, without blocking any thread. Exceptions thrown
+/// by the coroutine are rethrown to the awaiting one.
+///
+/// \note Await 'thread_pool::schedule()' inside the coroutine to continue on
+///       one of the threads of a pool.
+template <typename T>
+class [[nodiscard]] task {
+public:
+    using promise_type = detail::task_promise<T>;
+    using value_type = T;
+
+public:
+    task(const task&) = delete;
+
+    task(task&& other) noexcept
+    : m_handle(std::exchange(other.m_handle, nullptr)) {}
+
+    ~task() {
+        if (m_handle) {
+            m_handle.destroy();
+        }
+    }
+
+    task& operator=(const task&) = delete;
+
+    task& operator=(task&& other) noexcept {
+        if (this != &other) {
+            if (m_handle) {
+                m_handle.destroy();
+            }
+            m_handle = std::exchange(other.m_handle, nullptr);
+        }
+        return *this;
+    }
+
+    /// Check if the task refers to a coroutine
+    bool is_valid() const noexcept { return static_cast<bool>(m_handle); }
+
+    /// Check if the coroutine has finished
+    bool is_ready() const noexcept { return !m_handle || m_handle.done(); }
+
+    /// Start the coroutine and suspend the awaiting one until it is done
+    auto operator co_await() noexcept {
+        struct awaiter {
+            bool await_ready() const noexcept { return handle.done(); }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                handle.promise().set_continuation(awaiting);
+                return handle;
+            }
+
+            T await_resume() { return handle.promise().result(); }
+
+            std::coroutine_handle<promise_type> handle;
+        };
+        assert(m_handle);
+        return awaiter {m_handle};
+    }
+
+private:
+    friend promise_type;
+
+    explicit task(std::coroutine_handle<promise_type> handle) noexcept
+    : m_handle(handle) {}
+
+private:
+    std::coroutine_handle<promise_type> m_handle;
+};
+
+namespace detail {
+
+template <typename T>
+task<T> task_promise<T>::get_return_object() noexcept {
+    return task<T>(std::coroutine_handle<task_promise>::from_promise(*this));
+}
+
+inline task<void> task_promise<void>::get_return_object() noexcept {
+    return task<void>(std::coroutine_handle<task_promise>::from_promise(*this));
+}
+
+// coroutine awaiting a task and counting down a latch when done, used to
+// wait for a task from a regular function
+template <typename T>
+class blocking_task {
+public:
+    struct promise_type : task_promise<T> {
+        blocking_task get_return_object() noexcept {
+            return blocking_task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        auto final_suspend() const noexcept {
+            struct awaiter {
+                bool await_ready() const noexcept { return false; }
+
+                void await_suspend(std::coroutine_handle<promise_type> handle) const noexcept {
+                    handle.promise().done->count_down();
+                }
+
+                void await_resume() const noexcept {}
+            };
+            return awaiter {};
+        }
+
+        latch* done = nullptr;
+    };
+
+public:
+    blocking_task(const blocking_task&) = delete;
+    blocking_task& operator=(const blocking_task&) = delete;
+
+    ~blocking_task() { m_handle.destroy(); }
+
+    void start(latch& done) {
+        m_handle.promise().done = &done;
+        m_handle.resume();
+    }
+
+    T result() { return m_handle.promise().result(); }
+
+private:
+    explicit blocking_task(std::coroutine_handle<promise_type> handle) noexcept
+    : m_handle(handle) {}
+
+private:
+    std::coroutine_handle<promise_type> m_handle;
+};
+
+template <typename T>
+blocking_task<T> make_blocking_task(task<T>& t) {
+    co_return co_await t;
+}
+
+inline blocking_task<void> make_blocking_task(task<void>& t) {
+    co_await t;
+}
+
+// coroutine that is started immediately and destroys itself when done
+struct detached_task {
+    struct promise_type {
+        detached_task get_return_object() const noexcept { return {}; }
+
+        std::suspend_never initial_suspend() const noexcept { return {}; }
+
+        std::suspend_never final_suspend() const noexcept { return {}; }
+
+        void return_void() const noexcept {}
+
+        void unhandled_exception() const noexcept { std::terminate(); }
+    };
+};
+
+inline detached_task run_detached(thread_pool& pool, task<void> t) {
+    co_await pool.schedule();
+    co_await t;
+}
+
+} // namespace detail
+
+/// Run the task and block the calling thread until it is done
+///
+/// \return The result of the task
+template <typename T>
+T sync_wait(task<T> t) {
+    latch done(1);
+    auto blocking = detail::make_blocking_task(t);
+    blocking.start(done);
+    done.wait();
+    return blocking.result();
+}
+
+/// Run the task on the pool without waiting for it
+///
+/// \warning The task must not throw, exceptions terminate the program.
+inline void spawn(thread_pool& pool, task<void> t) {
+    detail::run_detached(pool, std::move(t));
+}
+
+/// Counting semaphore suspending the awaiting coroutines instead of blocking
+///
+/// \note The coroutines are resumed on the thread releasing the semaphore.
+class async_semaphore {
+    class acquire_awaiter;
+
+public:
+    /// Create a new semaphore with the given count
+    explicit async_semaphore(std::ptrdiff_t count = 0)
+    : m_count(count) {
+        assert(count >= 0);
+    }
+
+    async_semaphore(const async_semaphore&) = delete;
+    async_semaphore& operator=(const async_semaphore&) = delete;
+
+    /// Get an awaitable decrementing the internal counter, suspending the
+    /// awaiting coroutine while it is zero
+    [[nodiscard]] acquire_awaiter acquire() noexcept;
+
+    /// Decrement the internal counter without suspending
+    ///
+    /// \return true if the counter was decremented, false if it was zero
+    bool try_acquire() noexcept {
+        std::lock_guard lock(m_mutex);
+        if (m_count == 0) {
+            return false;
+        }
+        --m_count;
+        return true;
+    }
+
+    /// Increment the internal counter and resume awaiting coroutines
+    void release(std::ptrdiff_t update = 1) {
+        assert(update >= 0);
+        acquire_awaiter* resumed = nullptr;
+        {
+            std::lock_guard lock(m_mutex);
+            // hand the count to the waiting coroutines in order
+            auto tail = &resumed;
+            for (; update > 0 && m_head; --update) {
+                *tail = std::exchange(m_head, m_head->m_next);
+                tail = &(*tail)->m_next;
+            }
+            *tail = nullptr;
+            if (!m_head) {
+                m_tail = nullptr;
+            }
+            m_count += update;
+        }
+        while (resumed) {
+            // resuming the coroutine might destroy the awaiter
+            std::exchange(resumed, resumed->m_next)->m_handle.resume();
+        }
+    }
+
+private:
+    class acquire_awaiter {
+        friend class async_semaphore;
+
+    public:
+        bool await_ready() const noexcept { return m_semaphore.try_acquire(); }
+
+        bool await_suspend(std::coroutine_handle<> handle) {
+            m_handle = handle;
+            std::lock_guard lock(m_semaphore.m_mutex);
+            if (m_semaphore.m_count > 0) {
+                --m_semaphore.m_count;
+                return false;
+            }
+            (m_semaphore.m_tail ? m_semaphore.m_tail->m_next : m_semaphore.m_head) = this;
+            m_semaphore.m_tail = this;
+            return true;
+        }
+
+        void await_resume() const noexcept {}
+
+    private:
+        explicit acquire_awaiter(async_semaphore& semaphore) noexcept
+        : m_semaphore(semaphore) {}
+
+    private:
+        async_semaphore& m_semaphore;
+        std::coroutine_handle<> m_handle;
+        acquire_awaiter* m_next = nullptr;
+    };
+
+private:
+    std::mutex m_mutex;
+    std::ptrdiff_t m_count;
+    acquire_awaiter* m_head = nullptr;
+    acquire_awaiter* m_tail = nullptr;
+};
+
+inline async_semaphore::acquire_awaiter async_semaphore::acquire() noexcept {
+    return acquire_awaiter(*this);
+}
+
+} // namespace concurrency
+
+// bring symbols into parent namespace
+
+using concurrency::async_semaphore;
+using concurrency::spawn;
+using concurrency::sync_wait;
+using concurrency::task;
+
+} // namespace shard
+
+#endif
@@ -0,0 +1,27 @@
+// Copyright (c) 2026 Miklos Molnar. All rights reserved.
+
+#pragma once
+
+#include <optional>
+
+namespace shard::concurrency::detail {
+
+/// Consumer waiting asynchronously for the next item of a channel
+///
+/// The channel hands the item to the waiter directly, then completes it
+/// outside of its lock. The value is left empty if the channel was closed.
+template <typename T>
+class async_pop_waiter {
+public:
+    /// Called once the value has been set or the channel was closed
+    virtual void complete() = 0;
+
+public:
+    std::optional<T> value;
+    async_pop_waiter* next = nullptr;
+
+protected:
+    ~async_pop_waiter() = default;
+};
+
+} // namespace shard::concurrency::detail
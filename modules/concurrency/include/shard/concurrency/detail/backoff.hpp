@@ -0,0 +1,68 @@
+// Copyright (c) 2026 Miklos Molnar. All rights reserved.
+
+#pragma once
+
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#include <intrin.h>
+#elif defined(__i386__) || defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+#include <thread>
+
+namespace shard::concurrency::detail {
+
+/// Hint the processor that the calling thread is busy waiting
+inline void cpu_relax() noexcept {
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+    _mm_pause();
+#elif defined(__i386__) || defined(__x86_64__)
+    _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+/// Busy wait until the predicate holds or the number of tries is exhausted
+///
+/// \return The last result of the predicate
+template <typename Predicate>
+bool spin_until(Predicate&& predicate, int count = 64) {
+    for (auto i = 0; i < count; ++i) {
+        if (predicate()) {
+            return true;
+        }
+        cpu_relax();
+    }
+    return predicate();
+}
+
+/// Exponentially growing pause between attempts on a contended atomic
+///
+/// Once the pause reaches the limit the thread yields instead, so that a
+/// preempted owner can make progress.
+class exponential_backoff {
+public:
+    /// Pause the calling thread before the next attempt
+    void pause() noexcept {
+        if (m_count <= max_count) {
+            for (auto i = 0u; i < m_count; ++i) {
+                cpu_relax();
+            }
+            m_count *= 2;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+
+    /// Restart from the shortest pause
+    void reset() noexcept { m_count = 1; }
+
+private:
+    static constexpr unsigned int max_count = 64;
+
+private:
+    unsigned int m_count = 1;
+};
+
+} // namespace shard::concurrency::detail
@@ -0,0 +1,11 @@
+// Copyright (c) 2026 Miklos Molnar. All rights reserved.
+
+#pragma once
+
+/// Set to 1 if the compiler and the standard library support C++20 coroutines
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#define SHARD_HAS_COROUTINES 1
+#include <coroutine>
+#else
+#define SHARD_HAS_COROUTINES 0
+#endif
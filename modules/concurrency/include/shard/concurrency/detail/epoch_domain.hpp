@@ -0,0 +1,193 @@
+// Copyright (c) 2026 Miklos Molnar. All rights reserved.
+
+#pragma once
+
+#include "shard/concurrency/cache_line.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace shard::concurrency::detail {
+
+/// Epoch-based reclamation of objects that readers might still access
+///
+/// Readers pin the current epoch while they access shared objects. Objects
+/// removed by writers are retired with the epoch they were removed in and are
+/// only destroyed once the epoch has advanced twice, which can only happen
+/// after every reader pinned at the time has left.
+///
+/// \see "Practical lock-freedom" (Keir Fraser)
+class epoch_domain {
+    struct record;
+
+public:
+    using deleter_type = void (*)(void*);
+
+    /// RAII pin of the current epoch
+    class guard {
+        friend class epoch_domain;
+
+    public:
+        guard(const guard&) = delete;
+
+        guard(guard&& other) noexcept
+        : m_record(std::exchange(other.m_record, nullptr)) {}
+
+        ~guard() {
+            if (m_record && --m_record->depth == 0) {
+                m_record->epoch.store(quiescent, std::memory_order_release);
+            }
+        }
+
+        guard& operator=(const guard&) = delete;
+        guard& operator=(guard&&) = delete;
+
+    private:
+        explicit guard(record* r) noexcept
+        : m_record(r) {}
+
+    private:
+        record* m_record;
+    };
+
+public:
+    epoch_domain(const epoch_domain&) = delete;
+    epoch_domain& operator=(const epoch_domain&) = delete;
+
+    ~epoch_domain() {
+        for (auto& r : m_retired) {
+            r.deleter(r.pointer);
+        }
+        auto record = m_records.load(std::memory_order_acquire);
+        while (record) {
+            delete std::exchange(record, record->next);
+        }
+    }
+
+    /// Get the domain shared by the whole process
+    static epoch_domain& global() {
+        static epoch_domain domain;
+        return domain;
+    }
+
+    /// Pin the current epoch for the calling thread
+    ///
+    /// \note Pins can be nested, the epoch is released with the outermost.
+    guard pin() {
+        auto record = local_record();
+        if (record->depth++ == 0) {
+            // announce the epoch before reading any shared pointer, the
+            // sequential consistency orders it with the writers' checks
+            record->epoch.store(m_epoch.load(std::memory_order_relaxed), std::memory_order_seq_cst);
+        }
+        return guard(record);
+    }
+
+    /// Retire an object that has been made unreachable for new readers
+    void retire(void* pointer, deleter_type deleter) {
+        {
+            std::lock_guard lock(m_mutex);
+            m_retired.push_back({pointer, deleter, m_epoch.load(std::memory_order_seq_cst)});
+        }
+        collect();
+    }
+
+    /// Try to advance the epoch and destroy the objects no longer accessible
+    void collect() {
+        std::vector<retired> ready;
+        {
+            std::lock_guard lock(m_mutex);
+            auto epoch = try_advance();
+            auto it = std::partition(m_retired.begin(), m_retired.end(), [epoch](const retired& r) {
+                return r.epoch + 2 > epoch;
+            });
+            ready.assign(it, m_retired.end());
+            m_retired.erase(it, m_retired.end());
+        }
+        // the deleters might retire objects themselves
+        for (auto& r : ready) {
+            r.deleter(r.pointer);
+        }
+    }
+
+private:
+    // per-thread state, reused by other threads once its thread exits
+    struct alignas(cache_line_size) record {
+        std::atomic<std::uint64_t> epoch = ATOMIC_VAR_INIT(0);
+        std::atomic<bool> is_used = ATOMIC_VAR_INIT(true);
+        unsigned int depth = 0;
+        record* next = nullptr;
+    };
+
+    // releases the record of the thread when it exits
+    struct record_handle {
+        ~record_handle() {
+            if (value) {
+                value->is_used.store(false, std::memory_order_release);
+            }
+        }
+
+        record* value = nullptr;
+    };
+
+    struct retired {
+        void* pointer;
+        deleter_type deleter;
+        std::uint64_t epoch;
+    };
+
+    static constexpr std::uint64_t quiescent = 0;
+
+private:
+    // the records are per thread, so there is only a single domain
+    epoch_domain() = default;
+
+    record* local_record() {
+        thread_local record_handle handle;
+        if (handle.value) {
+            return handle.value;
+        }
+        // reuse the record of a thread that has exited
+        for (auto r = m_records.load(std::memory_order_acquire); r; r = r->next) {
+            bool is_used = false;
+            if (!r->is_used.load(std::memory_order_relaxed)
+                && r->is_used.compare_exchange_strong(is_used, true, std::memory_order_acquire)) {
+                handle.value = r;
+                return r;
+            }
+        }
+        auto r = new record;
+        r->next = m_records.load(std::memory_order_relaxed);
+        while (!m_records.compare_exchange_weak(r->next, r, std::memory_order_release, std::memory_order_relaxed)) {}
+        handle.value = r;
+        return r;
+    }
+
+    // advance the epoch if every pinned thread has seen the current one,
+    // must be called with the lock held
+    std::uint64_t try_advance() {
+        auto epoch = m_epoch.load(std::memory_order_seq_cst);
+        for (auto r = m_records.load(std::memory_order_acquire); r; r = r->next) {
+            auto local = r->epoch.load(std::memory_order_seq_cst);
+            if (local != quiescent && local != epoch) {
+                return epoch;
+            }
+        }
+        m_epoch.store(epoch + 1, std::memory_order_seq_cst);
+        return epoch + 1;
+    }
+
+private:
+    // starts at 1 so that it never matches a quiescent record
+    std::atomic<std::uint64_t> m_epoch = ATOMIC_VAR_INIT(1);
+    std::atomic<record*> m_records = ATOMIC_VAR_INIT(nullptr);
+
+    std::mutex m_mutex;
+    std::vector<retired> m_retired;
+};
+
+} // namespace shard::concurrency::detail
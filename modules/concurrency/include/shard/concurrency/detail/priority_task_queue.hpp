@@ -0,0 +1,127 @@
+// Copyright (c) 2026 Miklos Molnar. All rights reserved.
+
+#pragma once
+
+#include "shard/concurrency/detail/task.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <limits>
+#include <utility>
+
+namespace shard::concurrency::detail {
+
+/// FIFO queues of tasks with multiple priority levels and aging
+///
+/// Level 0 is the highest priority. Waiting tasks are promoted by one level
+/// for every aging interval they spend in the queue, so the lower levels are
+/// not starved by a continuous stream of higher priority tasks.
+///
+/// \note It is not thread-safe.
+template <std::size_t Levels>
+class priority_task_queue {
+    static_assert(Levels > 0, "at least one level is required");
+
+public:
+    using clock = std::chrono::steady_clock;
+
+public:
+    explicit priority_task_queue(clock::duration aging)
+    : m_aging(aging) {}
+
+    /// Add the task to the end of the level
+    void push(task_ptr task, std::size_t level) {
+        m_levels[level].push_back({std::move(task), clock::now()});
+        ++m_size;
+    }
+
+    /// Remove the task with the highest priority, taking aging into account
+    ///
+    /// \return The task or nullptr if the queue is empty
+    task_ptr pop() { return m_size != 0 ? pop(next(clock::now()).first) : nullptr; }
+
+    /// Get the level the next task of 'pop()' has been promoted to by aging
+    ///
+    /// \return The level or 'Levels' if the queue is empty
+    std::size_t top_level() const {
+        if (m_size == 0) {
+            return Levels;
+        }
+        auto priority = next(clock::now()).second;
+        return priority > 0 ? static_cast<std::size_t>(priority) : 0;
+    }
+
+    /// Remove the first task of the level
+    ///
+    /// \return The task or nullptr if the level is empty
+    task_ptr pop(std::size_t level) {
+        auto& tasks = m_levels[level];
+        if (tasks.empty()) {
+            return nullptr;
+        }
+        auto result = std::move(tasks.front().task);
+        tasks.pop_front();
+        --m_size;
+        return result;
+    }
+
+    /// Destroy every task
+    void clear() {
+        for (auto& tasks : m_levels) {
+            tasks.clear();
+        }
+        m_size = 0;
+    }
+
+    /// Check if the queue is empty
+    bool is_empty() const noexcept { return m_size == 0; }
+
+    /// Get the number of tasks
+    std::size_t size() const noexcept { return m_size; }
+
+    /// Get the number of tasks on the level
+    std::size_t size(std::size_t level) const noexcept { return m_levels[level].size(); }
+
+private:
+    struct entry {
+        task_ptr task;
+        clock::time_point time;
+    };
+
+private:
+    // get the level of the next task and its priority after aging, the queue
+    // must not be empty
+    std::pair<std::size_t, std::ptrdiff_t> next(clock::time_point now) const {
+        auto best = Levels;
+        auto best_priority = std::numeric_limits<std::ptrdiff_t>::max();
+        for (std::size_t level = 0; level < Levels; ++level) {
+            if (m_levels[level].empty()) {
+                continue;
+            }
+            // the front of every level is its oldest task, ties are won by
+            // the higher level
+            auto priority = static_cast<std::ptrdiff_t>(level) - promotion(m_levels[level].front(), now);
+            if (priority < best_priority) {
+                best = level;
+                best_priority = priority;
+            }
+        }
+        return {best, best_priority};
+    }
+
+    // get the number of levels the task has been promoted by
+    std::ptrdiff_t promotion(const entry& e, clock::time_point now) const {
+        if (m_aging <= clock::duration::zero()) {
+            return 0;
+        }
+        return static_cast<std::ptrdiff_t>((now - e.time) / m_aging);
+    }
+
+private:
+    std::deque<entry> m_levels[Levels];
+    std::size_t m_size = 0;
+    clock::duration m_aging;
+};
+
+} // namespace shard::concurrency::detail
@@ -0,0 +1,56 @@
+// Copyright (c) 2026 Miklos Molnar. All rights reserved.
+
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+
+namespace shard::concurrency::detail {
+
+/// Waiter registered with several channels at once by select()
+///
+/// The channels signal it when an item is added or when they are closed.
+class select_waiter {
+public:
+    void notify() {
+        {
+            std::lock_guard lock(m_mutex);
+            m_signaled = true;
+        }
+        m_cv.notify_one();
+    }
+
+    /// Block until signaled or until the time point if given
+    ///
+    /// \return false if the time point has been reached
+    template <typename TimePoint>
+    bool wait(const TimePoint* time) {
+        std::unique_lock lock(m_mutex);
+        auto is_signaled = [this] { return m_signaled; };
+        if (time) {
+            if (!m_cv.wait_until(lock, *time, is_signaled)) {
+                return false;
+            }
+        } else {
+            m_cv.wait(lock, is_signaled);
+        }
+        m_signaled = false;
+        return true;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    bool m_signaled = false;
+};
+
+/// Registration of a select_waiter with one channel
+///
+/// The links are owned by select(), so registering never allocates.
+struct select_link {
+    select_waiter* waiter = nullptr;
+    select_link* prev = nullptr;
+    select_link* next = nullptr;
+};
+
+} // namespace shard::concurrency::detail
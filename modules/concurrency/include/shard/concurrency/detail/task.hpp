@@ -0,0 +1,67 @@
+// Copyright (c) 2026 Miklos Molnar. All rights reserved.
+
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace shard::concurrency::detail {
+
+/// Type-erased unit of work scheduled on a thread pool
+class task_base {
+public:
+    /// Execute the task
+    virtual void run() = 0;
+
+    /// Release the scheduler's ownership of the task
+    ///
+    /// \note This is called whether the task was executed or not.
+    virtual void destroy() noexcept { delete this; }
+
+public:
+    /// The time the task was queued at, only set by pools collecting metrics
+    std::chrono::steady_clock::time_point queued_at;
+
+protected:
+    virtual ~task_base() = default;
+};
+
+/// Task storing the callable inline, requiring a single allocation
+template <typename F>
+class task_impl final : public task_base {
+public:
+    template <typename U>
+    explicit task_impl(U&& fn)
+    : m_fn(std::forward<U>(fn)) {}
+
+    void run() override { m_fn(); }
+
+private:
+    F m_fn;
+};
+
+struct task_deleter {
+    void operator()(task_base* task) const noexcept { task->destroy(); }
+};
+
+using task_ptr = std::unique_ptr<task_base, task_deleter>;
+
+/// Create a new task from the callable
+template <typename F>
+task_ptr make_task(F&& fn) {
+    return task_ptr(new task_impl<std::decay_t<F>>(std::forward<F>(fn)));
+}
+
+/// Interface of anything that can execute tasks
+class executor {
+public:
+    /// Schedule the task for execution
+    virtual void execute(task_ptr task) = 0;
+
+protected:
+    ~executor() = default;
+};
+
+} // namespace shard::concurrency::detail
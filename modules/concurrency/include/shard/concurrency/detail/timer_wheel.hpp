@@ -0,0 +1,120 @@
+// Copyright (c) 2026 Miklos Molnar. All rights reserved.
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace shard::concurrency::detail {
+
+/// Hashed timing wheel
+///
+/// Time is divided into ticks of the given resolution, every value is put in
+/// the slot of the tick it expires in modulo the number of slots, so adding
+/// and expiring values does not depend on the number of pending timers.
+/// Values never expire before their time, but might expire up to a tick late.
+///
+/// \note It is not thread-safe.
+///
+/// \see "Hashed and Hierarchical Timing Wheels" (Varghese, Lauck, 1987)
+template <typename T>
+class timer_wheel {
+public:
+    using clock = std::chrono::steady_clock;
+
+public:
+    explicit timer_wheel(clock::duration resolution, std::size_t slot_count = 256)
+    : m_slots(slot_count)
+    , m_start(clock::now())
+    , m_resolution(resolution) {
+        assert(resolution > clock::duration::zero());
+        assert(slot_count > 0 && (slot_count & (slot_count - 1)) == 0);
+    }
+
+    /// Add a value expiring at the given time
+    void add(clock::time_point time, T value) {
+        // round up, so that the value never expires early
+        auto elapsed = std::max(time - m_start, clock::duration::zero());
+        auto tick = static_cast<std::uint64_t>((elapsed + m_resolution - clock::duration(1)) / m_resolution);
+        tick = std::max(tick, m_current + 1);
+        m_slots[tick & (m_slots.size() - 1)].push_back({tick, std::move(value)});
+        ++m_size;
+    }
+
+    /// Expire the values up to the given time, calling the function with each
+    template <typename F>
+    void advance(clock::time_point now, F&& fn) {
+        auto target = static_cast<std::uint64_t>(std::max(now - m_start, clock::duration::zero()) / m_resolution);
+        if (target <= m_current) {
+            return;
+        }
+        // every slot is visited at most once
+        auto count = std::min<std::uint64_t>(target - m_current, m_slots.size());
+        for (std::uint64_t i = 1; i <= count && m_size != 0; ++i) {
+            auto& slot = m_slots[(m_current + i) & (m_slots.size() - 1)];
+            for (std::size_t j = 0; j < slot.size();) {
+                if (slot[j].tick > target) {
+                    ++j;
+                    continue;
+                }
+                auto value = std::move(slot[j].value);
+                slot[j] = std::move(slot.back());
+                slot.pop_back();
+                --m_size;
+                fn(std::move(value));
+            }
+        }
+        m_current = target;
+    }
+
+    /// Get the start of the next tick that has values in its slot
+    ///
+    /// \note The values of the slot might belong to a later round of the
+    ///       wheel, the time is only a lower bound of the next expiry.
+    std::optional<clock::time_point> next_expiry() const {
+        if (m_size == 0) {
+            return std::nullopt;
+        }
+        for (std::uint64_t i = 1; i <= m_slots.size(); ++i) {
+            if (!m_slots[(m_current + i) & (m_slots.size() - 1)].empty()) {
+                return m_start + static_cast<clock::duration::rep>(m_current + i) * m_resolution;
+            }
+        }
+        return std::nullopt;
+    }
+
+    /// Destroy every value
+    void clear() {
+        for (auto& slot : m_slots) {
+            slot.clear();
+        }
+        m_size = 0;
+    }
+
+    /// Check if there are no values
+    bool is_empty() const noexcept { return m_size == 0; }
+
+    /// Get the number of values
+    std::size_t size() const noexcept { return m_size; }
+
+private:
+    struct entry {
+        std::uint64_t tick;
+        T value;
+    };
+
+private:
+    std::vector<std::vector<entry>> m_slots;
+    clock::time_point m_start;
+    clock::duration m_resolution;
+    std::uint64_t m_current = 0;
+    std::size_t m_size = 0;
+};
+
+} // namespace shard::concurrency::detail
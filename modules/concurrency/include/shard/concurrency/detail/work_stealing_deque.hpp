@@ -0,0 +1,160 @@
+// Copyright (c) 2026 Miklos Molnar. All rights reserved.
+
+#pragma once
+
+#include "shard/concurrency/cache_line.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace shard::concurrency::detail {
+
+/// Chase-Lev work-stealing deque of pointers
+///
+/// The owner thread pushes and pops at the bottom (LIFO), while any other
+/// thread can steal from the top (FIFO). The buffer grows when full, the old
+/// buffers are kept alive until the deque is destroyed since thieves might
+/// still be reading them.
+///
+/// \see "Correct and Efficient Work-Stealing for Weak Memory Models"
+///      (Lê, Pop, Cohen, Zappa Nardelli, 2013)
+template <typename T>
+class work_stealing_deque {
+    static_assert(std::is_pointer_v<T>, "work_stealing_deque can only store pointers");
+
+public:
+    using value_type = T;
+
+public:
+    explicit work_stealing_deque(std::int64_t capacity = 256) {
+        assert(capacity > 0 && (capacity & (capacity - 1)) == 0);
+        m_buffers.push_back(std::make_unique<buffer>(capacity));
+        m_buffer.store(m_buffers.back().get(), std::memory_order_relaxed);
+    }
+
+    work_stealing_deque(const work_stealing_deque&) = delete;
+    work_stealing_deque& operator=(const work_stealing_deque&) = delete;
+
+    /// Add a new item to the bottom of the deque
+    ///
+    /// \warning Must only be called by the owner thread
+    void push(value_type value) {
+        auto bottom = m_bottom.load(std::memory_order_relaxed);
+        auto top = m_top.load(std::memory_order_acquire);
+        auto buf = m_buffer.load(std::memory_order_relaxed);
+
+        if (bottom - top > buf->capacity - 1) {
+            buf = grow(buf, bottom, top);
+        }
+
+        buf->store(bottom, value);
+        std::atomic_thread_fence(std::memory_order_release);
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+
+    /// Remove an item from the bottom of the deque
+    ///
+    /// \warning Must only be called by the owner thread
+    ///
+    /// \return The item or nullptr if the deque was empty
+    value_type pop() {
+        auto bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+        auto buf = m_buffer.load(std::memory_order_relaxed);
+        m_bottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto top = m_top.load(std::memory_order_relaxed);
+
+        value_type result = nullptr;
+
+        if (top <= bottom) {
+            result = buf->load(bottom);
+            if (top == bottom) {
+                // the last item, race against the thieves
+                if (!m_top.compare_exchange_strong(top,
+                                                   top + 1,
+                                                   std::memory_order_seq_cst,
+                                                   std::memory_order_relaxed)) {
+                    result = nullptr;
+                }
+                m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            }
+        } else {
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+
+        return result;
+    }
+
+    /// Remove an item from the top of the deque
+    ///
+    /// \note It is safe to call this from multiple threads
+    ///
+    /// \return The item or nullptr if the deque was empty or if another thread
+    ///         won the race for the item
+    value_type steal() {
+        auto top = m_top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto bottom = m_bottom.load(std::memory_order_acquire);
+
+        if (top < bottom) {
+            auto buf = m_buffer.load(std::memory_order_acquire);
+            auto result = buf->load(top);
+            if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                return nullptr;
+            }
+            return result;
+        }
+
+        return nullptr;
+    }
+
+    /// Get the approximate number of items in the deque
+    std::size_t size() const noexcept {
+        auto bottom = m_bottom.load(std::memory_order_relaxed);
+        auto top = m_top.load(std::memory_order_relaxed);
+        return bottom > top ? static_cast<std::size_t>(bottom - top) : 0;
+    }
+
+    /// Check if the deque is (approximately) empty
+    bool is_empty() const noexcept { return size() == 0; }
+
+private:
+    struct buffer {
+        explicit buffer(std::int64_t capacity)
+        : capacity(capacity)
+        , mask(capacity - 1)
+        , data(std::make_unique<std::atomic<value_type>[]>(static_cast<std::size_t>(capacity))) {}
+
+        value_type load(std::int64_t i) const noexcept { return data[i & mask].load(std::memory_order_relaxed); }
+
+        void store(std::int64_t i, value_type value) noexcept { data[i & mask].store(value, std::memory_order_relaxed); }
+
+        std::int64_t capacity;
+        std::int64_t mask;
+        std::unique_ptr<std::atomic<value_type>[]> data;
+    };
+
+    buffer* grow(buffer* old, std::int64_t bottom, std::int64_t top) {
+        auto next = std::make_unique<buffer>(old->capacity * 2);
+        for (auto i = top; i != bottom; ++i) {
+            next->store(i, old->load(i));
+        }
+        auto result = next.get();
+        // the old buffer stays alive, thieves might still be reading from it
+        m_buffers.push_back(std::move(next));
+        m_buffer.store(result, std::memory_order_release);
+        return result;
+    }
+
+private:
+    alignas(cache_line_size) std::atomic<std::int64_t> m_top = ATOMIC_VAR_INIT(0);
+    alignas(cache_line_size) std::atomic<std::int64_t> m_bottom = ATOMIC_VAR_INIT(0);
+    std::atomic<buffer*> m_buffer = ATOMIC_VAR_INIT(nullptr);
+    std::vector<std::unique_ptr<buffer>> m_buffers;
+};
+
+} // namespace shard::concurrency::detail
@@ -0,0 +1,42 @@
+// Copyright (c) 2026 Miklos Molnar. All rights reserved.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace shard {
+namespace concurrency {
+
+/// Block the calling thread while the word holds the expected value
+///
+/// \note The call might return spuriously, the caller must check the value
+///       again.
+void futex_wait(const std::atomic<std::uint32_t>& word, std::uint32_t expected);
+
+/// Block the calling thread while the word holds the expected value or until
+/// the timeout has elapsed
+///
+/// \note The call might return spuriously, the caller must check the value
+///       again.
+///
+/// \return false if the timeout has elapsed, true otherwise
+bool futex_wait_for(const std::atomic<std::uint32_t>& word, std::uint32_t expected, std::chrono::nanoseconds timeout);
+
+/// Wake one of the threads blocked on the word
+void futex_wake_one(const std::atomic<std::uint32_t>& word);
+
+/// Wake every thread blocked on the word
+void futex_wake_all(const std::atomic<std::uint32_t>& word);
+
+} // namespace concurrency
+
+// bring symbols into parent namespace
+
+using concurrency::futex_wait;
+using concurrency::futex_wait_for;
+using concurrency::futex_wake_all;
+using concurrency::futex_wake_one;
+
+} // namespace shard
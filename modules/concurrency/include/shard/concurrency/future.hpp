@@ -0,0 +1,359 @@
+// Copyright (c) 2026 Miklos Molnar. All rights reserved.
+
+#pragma once
+
+#include "shard/concurrency/detail/task.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace shard {
+namespace concurrency {
+
+template <typename T>
+class future;
+
+namespace detail {
+
+/// Task that also holds the result of its execution
+///
+/// The state is shared between the scheduler and the future, the one that
+/// releases it last destroys it. This way the task and its result need only a
+/// single allocation.
+template <typename T>
+class future_state : public task_base {
+    static_assert(!std::is_reference_v<T>, "future cannot hold references");
+
+public:
+    using value_type = T;
+
+public:
+    explicit future_state(executor* executor) noexcept
+    : m_executor(executor) {}
+
+    void destroy() noexcept override {
+        // the task is destroyed without being executed
+        if (!is_ready()) {
+            set_exception(std::make_exception_ptr(std::future_error(std::future_errc::broken_promise)));
+        }
+        release();
+    }
+
+    void release() noexcept {
+        if (m_refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete this;
+        }
+    }
+
+    bool is_ready() const noexcept { return (m_flags.load(std::memory_order_acquire) & flag_ready) != 0; }
+
+    void wait() {
+        if (is_ready()) {
+            return;
+        }
+        std::unique_lock lock(m_mutex);
+        m_flags.fetch_or(flag_waiting, std::memory_order_acq_rel);
+        m_cv.wait(lock, [this] { return is_ready(); });
+    }
+
+    template <typename Clock, typename Duration>
+    bool wait_until(const std::chrono::time_point<Clock, Duration>& time) {
+        if (is_ready()) {
+            return true;
+        }
+        std::unique_lock lock(m_mutex);
+        m_flags.fetch_or(flag_waiting, std::memory_order_acq_rel);
+        return m_cv.wait_until(lock, time, [this] { return is_ready(); });
+    }
+
+    /// Get the result or rethrow the stored exception
+    ///
+    /// \warning The result must be ready
+    T take() {
+        assert(is_ready());
+        if (m_exception) {
+            std::rethrow_exception(m_exception);
+        }
+        if constexpr (!std::is_void_v<T>) {
+            return std::move(*m_value);
+        }
+    }
+
+    /// Get the stored exception if there is any
+    ///
+    /// \warning The result must be ready
+    const std::exception_ptr& exception() const noexcept { return m_exception; }
+
+    /// Register a task to be scheduled once the result is ready
+    void set_continuation(task_ptr continuation) {
+        m_continuation = std::move(continuation);
+        auto flags = m_flags.fetch_or(flag_continuation, std::memory_order_acq_rel);
+        if ((flags & flag_ready) != 0) {
+            m_executor->execute(std::move(m_continuation));
+        }
+    }
+
+    executor* get_executor() const noexcept { return m_executor; }
+
+protected:
+    /// Store the result of the function or the exception it throws
+    template <typename F>
+    void invoke(F&& fn) noexcept {
+        try {
+            if constexpr (std::is_void_v<T>) {
+                std::forward<F>(fn)();
+                m_value.emplace();
+            } else {
+                m_value.emplace(std::forward<F>(fn)());
+            }
+        } catch (...) {
+            m_exception = std::current_exception();
+        }
+        complete();
+    }
+
+    void set_exception(std::exception_ptr exception) noexcept {
+        m_exception = std::move(exception);
+        complete();
+    }
+
+private:
+    void complete() noexcept {
+        auto flags = m_flags.fetch_or(flag_ready, std::memory_order_acq_rel);
+        if ((flags & flag_waiting) != 0) {
+            {
+                // synchronize with the threads about to wait
+                std::lock_guard lock(m_mutex);
+            }
+            m_cv.notify_all();
+        }
+        if ((flags & flag_continuation) != 0) {
+            try {
+                m_executor->execute(std::move(m_continuation));
+            } catch (...) {
+                // the continuation is destroyed, its own future is broken
+            }
+        }
+    }
+
+private:
+    static constexpr std::uint8_t flag_ready = 1 << 0;
+    static constexpr std::uint8_t flag_waiting = 1 << 1;
+    static constexpr std::uint8_t flag_continuation = 1 << 2;
+
+    using storage_type = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+private:
+    // the scheduler and the future both hold a reference
+    std::atomic<int> m_refs = ATOMIC_VAR_INIT(2);
+    std::atomic<std::uint8_t> m_flags = ATOMIC_VAR_INIT(0);
+
+    executor* m_executor;
+    task_ptr m_continuation;
+
+    std::optional<storage_type> m_value;
+    std::exception_ptr m_exception;
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+};
+
+/// Task invoking a function with the bound arguments
+template <typename T, typename F, typename... Args>
+class packaged_task final : public future_state<T> {
+public:
+    template <typename U, typename... UArgs>
+    packaged_task(executor* executor, U&& fn, UArgs&&... args)
+    : future_state<T>(executor)
+    , m_fn(std::forward<U>(fn))
+    , m_args(std::forward<UArgs>(args)...) {}
+
+    void run() override {
+        this->invoke([this]() -> T { return std::apply(std::move(m_fn), std::move(m_args)); });
+    }
+
+private:
+    F m_fn;
+    std::tuple<Args...> m_args;
+};
+
+/// The result type of a function called with the result of another task
+template <typename F, typename T>
+struct continuation_result {
+    using type = std::invoke_result_t<F, T>;
+};
+
+template <typename F>
+struct continuation_result<F, void> {
+    using type = std::invoke_result_t<F>;
+};
+
+/// Task invoking a function with the result of another task
+template <typename T, typename U, typename F>
+class continuation_task final : public future_state<T> {
+public:
+    template <typename Fn>
+    continuation_task(future_state<U>* antecedent, Fn&& fn)
+    : future_state<T>(antecedent->get_executor())
+    , m_antecedent(antecedent)
+    , m_fn(std::forward<Fn>(fn)) {}
+
+    ~continuation_task() override { m_antecedent->release(); }
+
+    void run() override {
+        if (auto& exception = m_antecedent->exception()) {
+            this->set_exception(exception);
+            return;
+        }
+        this->invoke([this]() -> T {
+            if constexpr (std::is_void_v<U>) {
+                return std::invoke(std::move(m_fn));
+            } else {
+                return std::invoke(std::move(m_fn), m_antecedent->take());
+            }
+        });
+    }
+
+private:
+    future_state<U>* m_antecedent;
+    F m_fn;
+};
+
+} // namespace detail
+
+/// Handle to the result of a task scheduled on a thread pool
+template <typename T>
+class future {
+    template <typename U>
+    friend class future;
+
+    friend class thread_pool;
+
+public:
+    using value_type = T;
+
+public:
+    /// Create an invalid future
+    future() noexcept = default;
+
+    future(const future&) = delete;
+
+    future(future&& other) noexcept
+    : m_state(std::exchange(other.m_state, nullptr)) {}
+
+    ~future() {
+        if (m_state) {
+            m_state->release();
+        }
+    }
+
+    future& operator=(const future&) = delete;
+
+    future& operator=(future&& other) noexcept {
+        if (this != &other) {
+            if (m_state) {
+                m_state->release();
+            }
+            m_state = std::exchange(other.m_state, nullptr);
+        }
+        return *this;
+    }
+
+    /// Check if the future refers to a task
+    bool is_valid() const noexcept { return m_state != nullptr; }
+
+    /// Check if the result is available
+    bool is_ready() const noexcept {
+        assert(m_state);
+        return m_state->is_ready();
+    }
+
+    /// Block the calling thread until the result is available
+    void wait() const {
+        assert(m_state);
+        m_state->wait();
+    }
+
+    /// Block the calling thread until the result is available or the timeout
+    /// has elapsed
+    ///
+    /// \return true if the result is available, false otherwise
+    template <typename Rep, typename Period>
+    bool wait_for(const std::chrono::duration<Rep, Period>& timeout) const {
+        return wait_until(std::chrono::steady_clock::now() + timeout);
+    }
+
+    /// Block the calling thread until the result is available or the time
+    /// point has been reached
+    ///
+    /// \return true if the result is available, false otherwise
+    template <typename Clock, typename Duration>
+    bool wait_until(const std::chrono::time_point<Clock, Duration>& time) const {
+        assert(m_state);
+        return m_state->wait_until(time);
+    }
+
+    /// Get the result by blocking the calling thread until available
+    ///
+    /// \note If the task threw an exception, it is rethrown here. If the task
+    ///       was discarded without being executed, std::future_error is
+    ///       thrown.
+    ///
+    /// \warning The future is no longer valid after this call
+    T get() {
+        assert(m_state);
+        m_state->wait();
+        future tmp(std::move(*this));
+        return tmp.m_state->take();
+    }
+
+    /// Schedule a function to be called on the same thread pool with the
+    /// result once it is available
+    ///
+    /// \note If the task threw an exception, the function is not called and
+    ///       the returned future holds the same exception.
+    ///
+    /// \warning The future is no longer valid after this call
+    ///
+    /// \return A future holding the result of the function
+    template <typename F>
+    auto then(F&& fn) {
+        assert(m_state);
+        using result_type = typename detail::continuation_result<std::decay_t<F>, T>::type;
+        using task_type = detail::continuation_task<result_type, T, std::decay_t<F>>;
+
+        // the continuation takes over the reference held by this future
+        auto state = std::exchange(m_state, nullptr);
+        auto task = new task_type(state, std::forward<F>(fn));
+        future<result_type> result(task);
+        state->set_continuation(detail::task_ptr(task));
+        return result;
+    }
+
+private:
+    explicit future(detail::future_state<T>* state) noexcept
+    : m_state(state) {}
+
+private:
+    detail::future_state<T>* m_state = nullptr;
+};
+
+} // namespace concurrency
+
+// bring symbols into parent namespace
+
+using concurrency::future;
+
+} // namespace shard
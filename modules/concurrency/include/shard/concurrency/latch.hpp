@@ -0,0 +1,72 @@
+// Copyright (c) 2026 Miklos Molnar. All rights reserved.
+
+#pragma once
+
+#include "shard/concurrency/detail/backoff.hpp"
+#include "shard/concurrency/futex.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+namespace shard {
+namespace concurrency {
+
+/// Single-use counter that threads can wait on to reach zero
+///
+/// The waiting threads block on the counter itself with a futex, so counting
+/// down only makes a system call when the counter reaches zero.
+class latch {
+public:
+    /// Create a latch with the given count
+    explicit latch(std::ptrdiff_t count)
+    : m_count(static_cast<std::uint32_t>(count)) {
+        assert(count >= 0);
+    }
+
+    latch(const latch&) = delete;
+    latch& operator=(const latch&) = delete;
+
+    /// Decrement the counter, waking the waiting threads if it reaches zero
+    void count_down(std::ptrdiff_t count = 1) {
+        assert(count >= 0);
+        auto n = static_cast<std::uint32_t>(count);
+        auto previous = m_count.fetch_sub(n, std::memory_order_acq_rel);
+        assert(previous >= n);
+        if (previous == n) {
+            futex_wake_all(m_count);
+        }
+    }
+
+    /// Check if the counter has reached zero
+    bool try_wait() const noexcept { return m_count.load(std::memory_order_acquire) == 0; }
+
+    /// Block the calling thread until the counter reaches zero
+    void wait() const {
+        if (detail::spin_until([this] { return try_wait(); })) {
+            return;
+        }
+        for (auto count = m_count.load(std::memory_order_acquire); count != 0;
+             count = m_count.load(std::memory_order_acquire)) {
+            futex_wait(m_count, count);
+        }
+    }
+
+    /// Decrement the counter then block until it reaches zero
+    void arrive_and_wait(std::ptrdiff_t count = 1) {
+        count_down(count);
+        wait();
+    }
+
+private:
+    std::atomic<std::uint32_t> m_count;
+};
+
+} // namespace concurrency
+
+// bring symbols into parent namespace
+
+using concurrency::latch;
+
+} // namespace shard
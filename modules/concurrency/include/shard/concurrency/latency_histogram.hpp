@@ -0,0 +1,132 @@
+// Copyright (c) 2026 Miklos Molnar. All rights reserved.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace shard {
+namespace concurrency {
+namespace detail {
+
+class atomic_latency_histogram;
+
+} // namespace detail
+
+/// Histogram of durations with power of two sized buckets
+///
+/// Bucket 0 counts zero durations, bucket 'i' counts the durations in
+/// [2^(i-1), 2^i) nanoseconds. The last bucket also counts every longer
+/// duration.
+class latency_histogram {
+    friend class detail::atomic_latency_histogram;
+
+public:
+    static constexpr std::size_t bucket_count = 48;
+
+public:
+    /// Count the duration
+    void record(std::chrono::nanoseconds duration) noexcept { ++m_buckets[bucket_of(duration)]; }
+
+    /// Add the counts of the other histogram
+    void merge(const latency_histogram& other) noexcept {
+        for (std::size_t i = 0; i < bucket_count; ++i) {
+            m_buckets[i] += other.m_buckets[i];
+        }
+    }
+
+    /// Get the number of durations counted
+    std::uint64_t count() const noexcept {
+        std::uint64_t result = 0;
+        for (auto n : m_buckets) {
+            result += n;
+        }
+        return result;
+    }
+
+    /// Get the number of durations counted in the bucket
+    std::uint64_t bucket(std::size_t index) const noexcept { return m_buckets[index]; }
+
+    /// Get the upper bound of the durations that the given fraction of the
+    /// durations does not exceed
+    ///
+    /// \note The result is rounded up to the upper bound of a bucket.
+    std::chrono::nanoseconds percentile(double fraction) const noexcept {
+        assert(fraction >= 0.0 && fraction <= 1.0);
+        auto total = count();
+        if (total == 0) {
+            return std::chrono::nanoseconds(0);
+        }
+        auto rank = std::max<std::uint64_t>(static_cast<std::uint64_t>(fraction * static_cast<double>(total)), 1);
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < bucket_count; ++i) {
+            seen += m_buckets[i];
+            if (seen >= rank) {
+                return upper_bound(i);
+            }
+        }
+        return upper_bound(bucket_count - 1);
+    }
+
+public:
+    /// Get the index of the bucket counting the duration
+    static std::size_t bucket_of(std::chrono::nanoseconds duration) noexcept {
+        auto ns = static_cast<std::uint64_t>(std::max<std::chrono::nanoseconds::rep>(duration.count(), 0));
+        std::size_t width = 0;
+#if defined(__GNUC__) || defined(__clang__)
+        width = ns == 0 ? 0 : 64 - static_cast<std::size_t>(__builtin_clzll(ns));
+#else
+        for (; ns != 0; ns >>= 1) {
+            ++width;
+        }
+#endif
+        return std::min(width, bucket_count - 1);
+    }
+
+    /// Get the exclusive upper bound of the durations counted in the bucket
+    static std::chrono::nanoseconds upper_bound(std::size_t index) noexcept {
+        return std::chrono::nanoseconds(std::chrono::nanoseconds::rep(1) << index);
+    }
+
+private:
+    std::array<std::uint64_t, bucket_count> m_buckets {};
+};
+
+namespace detail {
+
+/// Histogram recorded by a single thread and read by any other
+class atomic_latency_histogram {
+public:
+    /// Count the duration
+    ///
+    /// \warning It is *NOT* safe to call this from multiple threads
+    void record(std::chrono::nanoseconds duration) noexcept {
+        auto& bucket = m_buckets[latency_histogram::bucket_of(duration)];
+        bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    /// Add the current counts to the histogram
+    void merge_into(latency_histogram& histogram) const noexcept {
+        for (std::size_t i = 0; i < latency_histogram::bucket_count; ++i) {
+            histogram.m_buckets[i] += m_buckets[i].load(std::memory_order_relaxed);
+        }
+    }
+
+private:
+    std::array<std::atomic<std::uint64_t>, latency_histogram::bucket_count> m_buckets {};
+};
+
+} // namespace detail
+
+} // namespace concurrency
+
+// bring symbols into parent namespace
+
+using concurrency::latency_histogram;
+
+} // namespace shard
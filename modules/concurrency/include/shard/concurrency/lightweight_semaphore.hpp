@@ -0,0 +1,134 @@
+// Copyright (c) 2026 Miklos Molnar. All rights reserved.
+
+#pragma once
+
+#include "shard/concurrency/detail/backoff.hpp"
+#include "shard/concurrency/futex.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace shard {
+namespace concurrency {
+
+/// Counting semaphore doing the uncontended operations in user space
+///
+/// The count is kept in an atomic word that blocked threads wait on with a
+/// futex, so system calls are only made when a thread has to block or when
+/// there are blocked threads to wake.
+class lightweight_semaphore {
+public:
+    /// Create a new semaphore with the given count
+    explicit lightweight_semaphore(std::ptrdiff_t count = 0)
+    : m_count(static_cast<std::uint32_t>(count)) {
+        assert(count >= 0 && count <= max());
+    }
+
+    lightweight_semaphore(const lightweight_semaphore&) = delete;
+    lightweight_semaphore& operator=(const lightweight_semaphore&) = delete;
+
+    /// Decrement the internal counter or block
+    void acquire() {
+        if (detail::spin_until([this] { return try_acquire(); })) {
+            return;
+        }
+        while (!wait_and_acquire<std::chrono::steady_clock::time_point>(nullptr)) {}
+    }
+
+    /// Decrement the internal counter without blocking
+    ///
+    /// \return true if the counter was decremented, false if it was zero
+    bool try_acquire() noexcept {
+        auto count = m_count.load(std::memory_order_relaxed);
+        while (count != 0) {
+            if (m_count.compare_exchange_weak(count, count - 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// Decrement the internal counter or block until the timeout has elapsed
+    ///
+    /// \return true if the counter was decremented, false otherwise
+    template <typename Rep, typename Period>
+    bool try_acquire_for(const std::chrono::duration<Rep, Period>& timeout) {
+        return try_acquire_until(std::chrono::steady_clock::now() + timeout);
+    }
+
+    /// Decrement the internal counter or block until the time point has been
+    /// reached
+    ///
+    /// \return true if the counter was decremented, false otherwise
+    template <typename Clock, typename Duration>
+    bool try_acquire_until(const std::chrono::time_point<Clock, Duration>& time) {
+        if (detail::spin_until([this] { return try_acquire(); })) {
+            return true;
+        }
+        while (Clock::now() < time) {
+            if (wait_and_acquire(&time)) {
+                return true;
+            }
+        }
+        return try_acquire();
+    }
+
+    /// Increment the internal counter and unblock acquirers
+    ///
+    /// \note At most a single system call is made regardless of the count.
+    void release(std::ptrdiff_t count = 1) {
+        assert(count >= 0);
+        if (count == 0) {
+            return;
+        }
+        m_count.fetch_add(static_cast<std::uint32_t>(count), std::memory_order_seq_cst);
+        auto waiters = m_waiters.load(std::memory_order_seq_cst);
+        if (waiters == 0) {
+            return;
+        }
+        if (count == 1) {
+            futex_wake_one(m_count);
+        } else {
+            futex_wake_all(m_count);
+        }
+    }
+
+public:
+    /// Get the maximum value of the internal counter
+    static constexpr std::ptrdiff_t max() noexcept { return std::numeric_limits<std::int32_t>::max(); }
+
+private:
+    // block until the count is non-zero then try to take one, registering as
+    // a waiter first so that a concurrent release either sees the waiter or
+    // its increment is seen here
+    template <typename TimePoint>
+    bool wait_and_acquire(const TimePoint* time) {
+        m_waiters.fetch_add(1, std::memory_order_seq_cst);
+        if (m_count.load(std::memory_order_seq_cst) == 0) {
+            if (time) {
+                auto remaining = *time - TimePoint::clock::now();
+                futex_wait_for(m_count, 0, std::chrono::duration_cast<std::chrono::nanoseconds>(remaining));
+            } else {
+                futex_wait(m_count, 0);
+            }
+        }
+        m_waiters.fetch_sub(1, std::memory_order_relaxed);
+        return try_acquire();
+    }
+
+private:
+    std::atomic<std::uint32_t> m_count;
+    std::atomic<std::uint32_t> m_waiters = ATOMIC_VAR_INIT(0);
+};
+
+} // namespace concurrency
+
+// bring symbols into parent namespace
+
+using concurrency::lightweight_semaphore;
+
+} // namespace shard
@@ -4,10 +4,38 @@
 
 #include <mutex>
 #include <shared_mutex>
+#include <type_traits>
 
 namespace shard {
 namespace concurrency {
 
+template <typename Mutex>
+struct mutex_traits {
+    static constexpr bool is_shared = false;
+};
+
+template <>
+struct mutex_traits<std::shared_mutex> {
+    static constexpr bool is_shared = true;
+};
+
+template <>
+struct mutex_traits<std::shared_timed_mutex> {
+    static constexpr bool is_shared = true;
+};
+
+/// Lock for read-only access, shared if the mutex supports it and exclusive
+/// otherwise
+template <typename Mutex>
+class read_lock
+: public std::conditional_t<mutex_traits<Mutex>::is_shared, std::shared_lock<Mutex>, std::unique_lock<Mutex>> {
+    using base_type =
+        std::conditional_t<mutex_traits<Mutex>::is_shared, std::shared_lock<Mutex>, std::unique_lock<Mutex>>;
+
+public:
+    using base_type::base_type;
+};
+
 template <template <typename> class Lock>
 struct lock_traits {};
 
@@ -26,10 +54,17 @@ struct lock_traits<std::shared_lock> {
     static constexpr bool is_read_only = true;
 };
 
+template <>
+struct lock_traits<read_lock> {
+    static constexpr bool is_read_only = true;
+};
+
 } // namespace concurrency
 
 // bring symbols into parent namespace
 
 using concurrency::lock_traits;
+using concurrency::mutex_traits;
+using concurrency::read_lock;
 
 } // namespace shard
@@ -0,0 +1,280 @@
+// Copyright (c) 2026 Miklos Molnar. All rights reserved.
+
+#pragma once
+
+#include "shard/concurrency/cache_line.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace shard {
+namespace concurrency {
+
+/// Bounded lock-free multi-producer multi-consumer queue
+///
+/// Every slot has a sequence number telling whether it is ready to be written
+/// or read in the current lap, so producers and consumers only contend on
+/// their own index, which are kept on separate cache lines.
+///
+/// Items are created before their slot is claimed unless that cannot throw,
+/// so a throwing constructor leaves the queue untouched. Moving the items must
+/// not throw, as a claimed slot has to be published.
+///
+/// \see "Bounded MPMC queue" (Dmitry Vyukov)
+template <typename T, std::size_t Capacity>
+class mpmc_queue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "capacity must be a power of 2");
+    static_assert(std::is_nothrow_move_constructible_v<T>, "moving the items must not throw");
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+
+public:
+    mpmc_queue()
+    : m_slots(std::make_unique<slot[]>(Capacity)) {
+        for (size_type i = 0; i < Capacity; ++i) {
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    mpmc_queue(const mpmc_queue&) = delete;
+    mpmc_queue& operator=(const mpmc_queue&) = delete;
+
+    /// Destroy the items still in the queue
+    ~mpmc_queue() {
+        while (try_pop()) {}
+    }
+
+    /// Add a new item to the queue by copying it
+    ///
+    /// \note It is safe to call this from multiple threads
+    ///
+    /// \return true if the item was added, false if the queue was full
+    bool try_push(const value_type& value) { return try_emplace(value); }
+
+    /// Add a new item to the queue by moving it
+    ///
+    /// \note It is safe to call this from multiple threads
+    ///
+    /// \return true if the item was added, false if the queue was full
+    bool try_push(value_type&& value) { return try_emplace(std::move(value)); }
+
+    /// Add a new item to the queue by creating it in-place
+    ///
+    /// \note It is safe to call this from multiple threads
+    ///
+    /// \return true if the item was added, false if the queue was full
+    template <typename... Args>
+    bool try_emplace(Args&&... args) {
+        if constexpr (std::is_nothrow_constructible_v<value_type, Args&&...>) {
+            auto [pos, count] = claim(m_head, 0, 1);
+            if (count == 0) {
+                return false;
+            }
+            publish(pos, std::forward<Args>(args)...);
+            return true;
+        } else {
+            value_type value(std::forward<Args>(args)...);
+            return try_emplace(std::move(value));
+        }
+    }
+
+    /// Pop and retrieve the next item from the queue
+    ///
+    /// \note It is safe to call this from multiple threads
+    ///
+    /// \return The item or nullopt if the queue was empty
+    std::optional<value_type> try_pop() {
+        auto [pos, count] = claim(m_tail, 1, 1);
+        if (count == 0) {
+            return std::nullopt;
+        }
+        auto& s = m_slots[pos & mask];
+        auto result = std::make_optional(std::move(*s.data()));
+        release(s, pos);
+        return result;
+    }
+
+    /// Pop and retrieve the next item from the queue
+    ///
+    /// \note It is safe to call this from multiple threads
+    ///
+    /// \param out The reference to be assigned the value
+    ///
+    /// \return true if an item was retrieved, false if the queue was empty
+    bool try_pop(value_type& out) {
+        auto [pos, count] = claim(m_tail, 1, 1);
+        if (count == 0) {
+            return false;
+        }
+        auto& s = m_slots[pos & mask];
+        if constexpr (std::is_nothrow_move_assignable_v<value_type>) {
+            out = std::move(*s.data());
+            release(s, pos);
+        } else {
+            // the slot is released before the assignment can throw
+            value_type value(std::move(*s.data()));
+            release(s, pos);
+            out = std::move(value);
+        }
+        return true;
+    }
+
+    /// Add as many items from the range as there is room for
+    ///
+    /// If the items can be copied without throwing, the slots are claimed with
+    /// a single atomic operation, so the items are kept together in the queue.
+    /// Otherwise every item is copied before claiming its slot.
+    ///
+    /// \note It is safe to call this from multiple threads
+    ///
+    /// \return The iterator past the last item that was added
+    template <typename InputIt>
+    InputIt try_push_batch(InputIt first, InputIt last) {
+        using reference = typename std::iterator_traits<InputIt>::reference;
+        if constexpr (std::is_nothrow_constructible_v<value_type, reference>) {
+            while (first != last) {
+                auto requested = static_cast<size_type>(std::distance(first, last));
+                auto [pos, count] = claim(m_head, 0, requested);
+                if (count == 0) {
+                    break;
+                }
+                for (size_type i = 0; i < count; ++i, ++first) {
+                    publish(pos + i, *first);
+                }
+            }
+        } else {
+            for (; first != last && try_emplace(*first); ++first) {}
+        }
+        return first;
+    }
+
+    /// Pop up to 'max' items from the queue
+    ///
+    /// The slots are claimed with a single atomic operation, so the items are
+    /// consecutive.
+    ///
+    /// \note It is safe to call this from multiple threads
+    ///
+    /// \return The number of items retrieved
+    template <typename OutputIt>
+    size_type try_pop_batch(OutputIt out, size_type max) {
+        auto [pos, count] = claim(m_tail, 1, max);
+        size_type i = 0;
+        try {
+            for (; i < count; ++i) {
+                // the slot is released before writing the output can throw
+                auto& s = m_slots[(pos + i) & mask];
+                value_type value(std::move(*s.data()));
+                release(s, pos + i);
+                *out = std::move(value);
+                ++out;
+            }
+        } catch (...) {
+            // the remaining slots are claimed, so they must be released for
+            // the queue to stay usable, their items are lost
+            while (++i < count) {
+                release(m_slots[(pos + i) & mask], pos + i);
+            }
+            throw;
+        }
+        return count;
+    }
+
+    /// Check if the queue is empty
+    ///
+    /// \note The result is only an approximation when used concurrently
+    bool is_empty() const noexcept { return size() == 0; }
+
+    /// Get the number of items in the queue
+    ///
+    /// \note The result is only an approximation when used concurrently
+    size_type size() const noexcept {
+        auto tail = m_tail.load(std::memory_order_relaxed);
+        auto head = m_head.load(std::memory_order_relaxed);
+        return head > tail ? std::min<size_type>(head - tail, Capacity) : 0;
+    }
+
+    /// Get the maximum number of items in the queue
+    constexpr size_type capacity() const noexcept { return Capacity; }
+
+private:
+    struct slot {
+        value_type* data() noexcept { return std::launder(reinterpret_cast<value_type*>(storage)); }
+
+        std::atomic<size_type> sequence;
+        alignas(value_type) std::byte storage[sizeof(value_type)];
+    };
+
+    static constexpr size_type mask = Capacity - 1;
+
+private:
+    // claim up to 'max' consecutive slots whose sequence number is ahead of
+    // their position by 'offset' (0 for free slots, 1 for full slots)
+    std::pair<size_type, size_type> claim(std::atomic<size_type>& index, size_type offset, size_type max) {
+        auto pos = index.load(std::memory_order_relaxed);
+        while (max != 0) {
+            size_type count = 0;
+            bool is_stale = false;
+            while (count < max && count < Capacity) {
+                auto sequence = m_slots[(pos + count) & mask].sequence.load(std::memory_order_acquire);
+                auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos + count + offset);
+                if (diff == 0) {
+                    ++count;
+                    continue;
+                }
+                // a sequence number ahead of the position means that another
+                // thread has already claimed the slot
+                is_stale = count == 0 && diff > 0;
+                break;
+            }
+            if (is_stale) {
+                pos = index.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (count == 0) {
+                break;
+            }
+            if (index.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed)) {
+                return {pos, count};
+            }
+        }
+        return {pos, 0};
+    }
+
+    // create the item in the claimed slot and mark it as full
+    template <typename... Args>
+    void publish(size_type pos, Args&&... args) noexcept {
+        auto& s = m_slots[pos & mask];
+        new (s.data()) value_type(std::forward<Args>(args)...);
+        s.sequence.store(pos + 1, std::memory_order_release);
+    }
+
+    // destroy the item and mark the slot as free for the next lap
+    void release(slot& s, size_type pos) {
+        s.data()->~value_type();
+        s.sequence.store(pos + Capacity, std::memory_order_release);
+    }
+
+private:
+    alignas(cache_line_size) std::atomic<size_type> m_head = ATOMIC_VAR_INIT(0);
+    alignas(cache_line_size) std::atomic<size_type> m_tail = ATOMIC_VAR_INIT(0);
+    alignas(cache_line_size) std::unique_ptr<slot[]> m_slots;
+};
+
+} // namespace concurrency
+
+// bring symbols into parent namespace
+
+using concurrency::mpmc_queue;
+
+} // namespace shard
@@ -2,11 +2,19 @@
 
 #pragma once
 
+#include "shard/concurrency/cache_line.hpp"
+#include "shard/concurrency/detail/backoff.hpp"
+#include "shard/concurrency/futex.hpp"
+
+#include <algorithm>
 #include <atomic>
 #include <cassert>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <new>
 #include <optional>
+#include <thread>
 #include <utility>
 
 namespace shard {
@@ -22,6 +30,19 @@ public:
     mpsc_queue() {
         m_data = new std::byte[sizeof(value_type) * Capacity];
         m_states = new std::atomic<bool>[Capacity];
+        for (size_type i = 0; i < Capacity; ++i) {
+            m_states[i].store(false, std::memory_order_relaxed);
+        }
+    }
+
+    mpsc_queue(const mpsc_queue&) = delete;
+    mpsc_queue& operator=(const mpsc_queue&) = delete;
+
+    /// Destroy the items still in the queue
+    ~mpsc_queue() {
+        while (pop()) {}
+        delete[] m_states;
+        delete[] m_data;
     }
 
     /// Add a new item to the queue by copying it
@@ -29,38 +50,14 @@ public:
     /// \note It is safe to call this from multiple threads
     ///
     /// \return true if the item was added, false otherwise
-    bool push(const value_type& value) {
-        if (is_full()) {
-            return false;
-        }
-
-        auto head = next_head();
-        auto offset = sizeof(value_type) * head;
-        auto memory = reinterpret_cast<value_type*>(&m_data[offset]);
-        *memory = value;
-        m_states[head].store(true, std::memory_order_release);
-
-        return true;
-    }
+    bool push(const value_type& value) { return emplace(value); }
 
     /// Add a new item to the queue by moving it
     ///
     /// \note It is safe to call this from multiple threads
     ///
     /// \return true if the item was added, false otherwise
-    bool push(value_type&& value) {
-        if (is_full()) {
-            return false;
-        }
-
-        auto head = next_head();
-        auto offset = sizeof(value_type) * head;
-        auto memory = reinterpret_cast<value_type*>(&m_data[offset]);
-        *memory = std::move(value);
-        m_states[head].store(true, std::memory_order_release);
-
-        return true;
-    }
+    bool push(value_type&& value) { return emplace(std::move(value)); }
 
     /// Add a new item to the queue by creating it in-place
     ///
@@ -77,6 +74,7 @@ public:
         auto offset = sizeof(value_type) * head;
         new (&m_data[offset]) value_type(std::forward<Args>(args)...);
         m_states[head].store(true, std::memory_order_release);
+        wake_consumer();
 
         return true;
     }
@@ -89,9 +87,9 @@ public:
             return std::nullopt;
         }
 
-        assert(m_states[m_tail]);
-        auto offset = sizeof(value_type) * m_tail;
-        auto value = std::move(*reinterpret_cast<value_type*>(&m_data[offset]));
+        auto& item = slot(m_tail);
+        std::optional<value_type> value(std::move(item));
+        item.~value_type();
         m_states[m_tail].store(false, std::memory_order_release);
 
         if (++m_tail >= Capacity) {
@@ -104,6 +102,71 @@ public:
         return value;
     }
 
+    /// Pop the next item, blocking the calling thread until there is one
+    ///
+    /// The consumer spins for a while, then yields and finally parks until a
+    /// producer signals it. The time spent spinning adapts to how quickly
+    /// items arrived in the previous waits.
+    ///
+    /// \warning It is *NOT* safe to call this from multiple threads
+    value_type pop_wait() {
+        while (true) {
+            if (auto value = pop()) {
+                return std::move(*value);
+            }
+            wait_ready(nullptr);
+        }
+    }
+
+    /// Pop the next item, blocking the calling thread until there is one or
+    /// the timeout has elapsed
+    ///
+    /// \warning It is *NOT* safe to call this from multiple threads
+    ///
+    /// \return The item or nullopt if the timeout has elapsed
+    template <typename Rep, typename Period>
+    std::optional<value_type> pop_wait(const std::chrono::duration<Rep, Period>& timeout) {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (true) {
+            if (auto value = pop()) {
+                return value;
+            }
+            if (!wait_ready(&deadline)) {
+                return pop();
+            }
+        }
+    }
+
+    /// Pop up to 'max' items from the queue
+    ///
+    /// The size of the queue is only updated once for the whole batch.
+    ///
+    /// \warning It is *NOT* safe to call this from multiple threads
+    ///
+    /// \return The number of items retrieved
+    template <typename OutputIt>
+    size_type drain(OutputIt out, size_type max) {
+        size_type count = 0;
+        while (count < max && m_states[m_tail].load(std::memory_order_acquire)) {
+            auto& item = slot(m_tail);
+            *out = std::move(item);
+            ++out;
+            item.~value_type();
+            m_states[m_tail].store(false, std::memory_order_release);
+
+            if (++m_tail >= Capacity) {
+                m_tail = 0;
+            }
+            ++count;
+        }
+
+        if (count != 0) {
+            m_size.fetch_sub(count, std::memory_order_release);
+        }
+
+        return count;
+    }
+
     bool is_empty() const { return m_size.load(std::memory_order_relaxed) == 0; }
 
     std::size_t size() const { return m_size.load(std::memory_order_relaxed); }
@@ -111,6 +174,73 @@ public:
     std::size_t capacity() const { return Capacity; }
 
 private:
+    using clock_type = std::chrono::steady_clock;
+
+    // the bounds of the number of spins before yielding
+    static constexpr int min_spin_count = 16;
+    static constexpr int max_spin_count = 4096;
+
+    // the number of yields before parking
+    static constexpr int yield_count = 8;
+
+private:
+    value_type& slot(size_type index) {
+        return *std::launder(reinterpret_cast<value_type*>(&m_data[sizeof(value_type) * index]));
+    }
+
+    bool is_ready() const { return m_states[m_tail].load(std::memory_order_acquire); }
+
+    // wait until the next item is published or the deadline is reached
+    bool wait_ready(const clock_type::time_point* deadline) {
+        for (auto i = 0; i < m_spin_count; ++i) {
+            if (is_ready()) {
+                m_spin_count = std::min(m_spin_count * 2, max_spin_count);
+                return true;
+            }
+            detail::cpu_relax();
+        }
+        for (auto i = 0; i < yield_count; ++i) {
+            if (is_ready()) {
+                return true;
+            }
+            std::this_thread::yield();
+        }
+
+        // items are not coming in quickly, spin less next time
+        m_spin_count = std::max(m_spin_count / 2, min_spin_count);
+
+        while (true) {
+            // announce the intention to park before checking for an item one
+            // last time, so that a concurrent producer either sees the flag or
+            // its item is seen here
+            m_parked.store(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (is_ready()) {
+                m_parked.store(0, std::memory_order_relaxed);
+                return true;
+            }
+            if (deadline) {
+                auto now = clock_type::now();
+                if (now >= *deadline) {
+                    m_parked.store(0, std::memory_order_relaxed);
+                    return false;
+                }
+                futex_wait_for(m_parked, 1, *deadline - now);
+            } else {
+                futex_wait(m_parked, 1);
+            }
+        }
+    }
+
+    // wake the consumer only if it is parked, keeping the common case free of
+    // system calls
+    void wake_consumer() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_parked.load(std::memory_order_relaxed) != 0 && m_parked.exchange(0, std::memory_order_relaxed) != 0) {
+            futex_wake_one(m_parked);
+        }
+    }
+
     bool is_full() {
         auto size = m_size.fetch_add(1, std::memory_order_acquire);
         if (size >= Capacity) {
@@ -138,6 +268,10 @@ private:
 
     std::atomic<size_type> m_head = ATOMIC_VAR_INIT(0);
     size_type m_tail = 0;
+
+    // consumer parking
+    int m_spin_count = min_spin_count;
+    alignas(cache_line_size) std::atomic<std::uint32_t> m_parked = ATOMIC_VAR_INIT(0);
 };
 
 } // namespace concurrency
@@ -0,0 +1,529 @@
+// Copyright (c) 2026 Miklos Molnar. All rights reserved.
+
+#pragma once
+
+#include "shard/concurrency/thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace shard {
+namespace concurrency {
+namespace detail {
+
+/// State shared between the calling thread and the helper tasks
+class parallel_state {
+public:
+    using invoke_type = void (*)(void*, std::size_t);
+
+public:
+    parallel_state(std::size_t count, void* fn, invoke_type invoke) noexcept
+    : m_count(count)
+    , m_fn(fn)
+    , m_invoke(invoke) {}
+
+    /// Execute chunks until there are none left
+    ///
+    /// \note The function is only accessed while there are unclaimed chunks,
+    ///       so helpers starting late never touch the caller's stack.
+    void work() {
+        std::size_t index;
+        while ((index = m_next.fetch_add(1, std::memory_order_relaxed)) < m_count) {
+            // skip the remaining work if a chunk has failed
+            if (!m_failed.load(std::memory_order_relaxed)) {
+                try {
+                    m_invoke(m_fn, index);
+                } catch (...) {
+                    if (!m_failed.exchange(true, std::memory_order_relaxed)) {
+                        m_exception = std::current_exception();
+                    }
+                }
+            }
+            if (m_done.fetch_add(1, std::memory_order_acq_rel) + 1 == m_count) {
+                {
+                    // synchronize with the calling thread about to wait
+                    std::lock_guard lock(m_mutex);
+                }
+                m_cv.notify_all();
+            }
+        }
+    }
+
+    /// Block until every chunk is done then rethrow the first exception
+    void wait() {
+        if (m_done.load(std::memory_order_acquire) != m_count) {
+            std::unique_lock lock(m_mutex);
+            m_cv.wait(lock, [this] { return m_done.load(std::memory_order_acquire) == m_count; });
+        }
+        if (m_exception) {
+            std::rethrow_exception(m_exception);
+        }
+    }
+
+private:
+    const std::size_t m_count;
+    void* m_fn;
+    invoke_type m_invoke;
+
+    std::atomic<std::size_t> m_next = ATOMIC_VAR_INIT(0);
+    std::atomic<std::size_t> m_done = ATOMIC_VAR_INIT(0);
+    std::atomic<bool> m_failed = ATOMIC_VAR_INIT(false);
+    std::exception_ptr m_exception;
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+};
+
+/// Call the function with every index in [0, count) on the pool
+///
+/// The calling thread executes chunks as well, and only waits for the ones
+/// already claimed by the other threads, so it is safe to call this from a
+/// task running on the same pool.
+template <typename F>
+void parallel_invoke(thread_pool& pool, std::size_t count, F& fn) {
+    if (count == 0) {
+        return;
+    }
+
+    auto helpers = std::min<std::size_t>(pool.thread_count(), count - 1);
+    if (helpers == 0) {
+        for (std::size_t i = 0; i < count; ++i) {
+            fn(i);
+        }
+        return;
+    }
+
+    auto invoke = [](void* f, std::size_t index) { (*static_cast<F*>(f))(index); };
+    auto state = std::make_shared<parallel_state>(count, std::addressof(fn), invoke);
+
+    for (std::size_t i = 0; i < helpers; ++i) {
+        pool.run([state] { state->work(); });
+    }
+
+    state->work();
+    state->wait();
+}
+
+/// Get a chunk size that gives every thread a few chunks to balance the load
+inline std::size_t default_grain(const thread_pool& pool, std::size_t size) {
+    return std::max<std::size_t>(1, size / (4 * (pool.thread_count() + 1)));
+}
+
+/// Split an iterator range into chunks of 'grain' elements
+template <typename Iterator>
+class chunked_range {
+public:
+    static constexpr bool is_random_access
+        = std::is_base_of_v<std::random_access_iterator_tag, typename std::iterator_traits<Iterator>::iterator_category>;
+
+public:
+    chunked_range(Iterator first, Iterator last, std::size_t grain)
+    : m_first(first)
+    , m_size(static_cast<std::size_t>(std::distance(first, last)))
+    , m_grain(std::max<std::size_t>(grain, 1)) {
+        m_count = (m_size + m_grain - 1) / m_grain;
+        if constexpr (!is_random_access) {
+            // forward iterators can't jump, so the boundaries are computed
+            m_bounds.reserve(m_count + 1);
+            m_bounds.push_back(first);
+            for (std::size_t i = 0; i < m_count; ++i) {
+                auto step = std::min(m_grain, m_size - i * m_grain);
+                m_bounds.push_back(std::next(m_bounds.back(), static_cast<std::ptrdiff_t>(step)));
+            }
+        }
+    }
+
+    /// Get the number of elements
+    std::size_t size() const noexcept { return m_size; }
+
+    /// Get the number of chunks
+    std::size_t count() const noexcept { return m_count; }
+
+    /// Get the offset of the first element of the chunk
+    std::size_t offset(std::size_t chunk) const noexcept { return chunk * m_grain; }
+
+    /// Get the first iterator of the chunk
+    Iterator begin(std::size_t chunk) const {
+        if constexpr (is_random_access) {
+            return std::next(m_first, static_cast<std::ptrdiff_t>(offset(chunk)));
+        } else {
+            return m_bounds[chunk];
+        }
+    }
+
+    /// Get the past-the-end iterator of the chunk
+    Iterator end(std::size_t chunk) const {
+        if constexpr (is_random_access) {
+            return std::next(m_first, static_cast<std::ptrdiff_t>(std::min(offset(chunk) + m_grain, m_size)));
+        } else {
+            return m_bounds[chunk + 1];
+        }
+    }
+
+private:
+    Iterator m_first;
+    std::size_t m_size;
+    std::size_t m_grain;
+    std::size_t m_count = 0;
+    std::vector<Iterator> m_bounds;
+};
+
+template <typename Iterator>
+chunked_range(Iterator, Iterator, std::size_t) -> chunked_range<Iterator>;
+
+template <typename T>
+inline constexpr bool is_index_v = std::is_integral_v<std::decay_t<T>>;
+
+/// Uninitialized storage for moving a range split into chunks
+template <typename T>
+class sort_buffer {
+public:
+    sort_buffer(std::size_t size, std::size_t grain)
+    : m_data(std::allocator<T>().allocate(size))
+    , m_size(size)
+    , m_grain(grain)
+    , m_is_constructed((size + grain - 1) / grain, false) {}
+
+    sort_buffer(const sort_buffer&) = delete;
+    sort_buffer& operator=(const sort_buffer&) = delete;
+
+    ~sort_buffer() {
+        for (std::size_t chunk = 0; chunk < m_is_constructed.size(); ++chunk) {
+            if (m_is_constructed[chunk]) {
+                std::destroy_n(m_data + chunk * m_grain, chunk_size(chunk));
+            }
+        }
+        std::allocator<T>().deallocate(m_data, m_size);
+    }
+
+    /// Move the elements of the chunk into the buffer
+    ///
+    /// \note It is safe to call this for different chunks from multiple
+    ///       threads
+    template <typename Iterator>
+    void construct(std::size_t chunk, Iterator first) {
+        std::uninitialized_move_n(first, chunk_size(chunk), m_data + chunk * m_grain);
+        m_is_constructed[chunk] = true;
+    }
+
+    T* data() const noexcept { return m_data; }
+
+private:
+    std::size_t chunk_size(std::size_t chunk) const noexcept { return std::min(m_grain, m_size - chunk * m_grain); }
+
+private:
+    T* m_data;
+    std::size_t m_size;
+    std::size_t m_grain;
+    // not a vector<bool>, as the chunks are constructed concurrently
+    std::vector<unsigned char> m_is_constructed;
+};
+
+/// Get the number of elements of the first sorted range among the first 'k'
+/// elements of the merged ranges, the elements of the first range go first
+/// on ties
+template <typename It1, typename It2, typename Compare>
+std::size_t merge_split(It1 a, std::size_t a_size, It2 b, std::size_t b_size, std::size_t k, Compare& comp) {
+    auto low = k > b_size ? k - b_size : 0;
+    auto high = std::min(k, a_size);
+    while (low < high) {
+        auto mid = low + (high - low) / 2;
+        // a[mid] is among the first k if it goes before b[k - mid - 1]
+        if (!comp(b[static_cast<std::ptrdiff_t>(k - mid - 1)], a[static_cast<std::ptrdiff_t>(mid)])) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+/// Merge the sorted ranges by moving the elements, the elements of the first
+/// range go first on ties
+template <typename It1, typename It2, typename OutputIt, typename Compare>
+OutputIt move_merge(It1 first1, It1 last1, It2 first2, It2 last2, OutputIt out, Compare& comp) {
+    for (; first1 != last1 && first2 != last2; ++out) {
+        if (comp(*first2, *first1)) {
+            *out = std::move(*first2);
+            ++first2;
+        } else {
+            *out = std::move(*first1);
+            ++first1;
+        }
+    }
+    out = std::move(first1, last1, out);
+    return std::move(first2, last2, out);
+}
+
+/// Merge the adjacent pairs of sorted runs from 'src' into 'dst'
+///
+/// Every merge is split into pieces of 'grain' elements of the output, the
+/// matching parts of the runs are found with a binary search, so the last
+/// rounds are as parallel as the first ones.
+template <typename SrcIt, typename DstIt, typename Compare>
+void merge_runs(thread_pool& pool,
+                SrcIt src,
+                DstIt dst,
+                const std::vector<std::size_t>& bounds,
+                std::size_t grain,
+                Compare& comp) {
+    struct piece {
+        // the runs [first, middle) and [middle, last)
+        std::size_t first;
+        std::size_t middle;
+        std::size_t last;
+        // the part of the merged runs, relative to 'first'
+        std::size_t begin;
+        std::size_t end;
+    };
+
+    std::vector<piece> pieces;
+    for (std::size_t i = 0; i + 1 < bounds.size(); i += 2) {
+        // a run without a pair is moved as it is
+        auto last = i + 2 < bounds.size() ? bounds[i + 2] : bounds[i + 1];
+        for (auto begin = bounds[i]; begin < last; begin += grain) {
+            pieces.push_back({bounds[i], bounds[i + 1], last, begin - bounds[i], std::min(begin + grain, last) - bounds[i]});
+        }
+    }
+
+    auto merge_fn = [&](std::size_t index) {
+        auto& p = pieces[index];
+        auto a = std::next(src, static_cast<std::ptrdiff_t>(p.first));
+        auto b = std::next(src, static_cast<std::ptrdiff_t>(p.middle));
+        auto a_size = p.middle - p.first;
+        auto b_size = p.last - p.middle;
+        auto a_begin = merge_split(a, a_size, b, b_size, p.begin, comp);
+        auto a_end = merge_split(a, a_size, b, b_size, p.end, comp);
+        move_merge(std::next(a, static_cast<std::ptrdiff_t>(a_begin)),
+                   std::next(a, static_cast<std::ptrdiff_t>(a_end)),
+                   std::next(b, static_cast<std::ptrdiff_t>(p.begin - a_begin)),
+                   std::next(b, static_cast<std::ptrdiff_t>(p.end - a_end)),
+                   std::next(dst, static_cast<std::ptrdiff_t>(p.first + p.begin)),
+                   comp);
+    };
+    parallel_invoke(pool, pieces.size(), merge_fn);
+}
+
+} // namespace detail
+
+// parallel_for
+
+/// Call the function with every index in [first, last) using the pool
+///
+/// \param grain The number of indices processed by a single task
+template <typename Index, typename F, typename = std::enable_if_t<detail::is_index_v<Index>>>
+void parallel_for(thread_pool& pool, Index first, Index last, std::size_t grain, F&& fn) {
+    if (last <= first) {
+        return;
+    }
+    auto size = static_cast<std::size_t>(last - first);
+    grain = std::max<std::size_t>(grain, 1);
+    auto chunk_fn = [&](std::size_t chunk) {
+        auto begin = first + static_cast<Index>(chunk * grain);
+        auto end = first + static_cast<Index>(std::min(chunk * grain + grain, size));
+        for (auto i = begin; i != end; ++i) {
+            fn(i);
+        }
+    };
+    detail::parallel_invoke(pool, (size + grain - 1) / grain, chunk_fn);
+}
+
+/// Call the function with every index in [first, last) using the pool
+template <typename Index, typename F, typename = std::enable_if_t<detail::is_index_v<Index>>>
+void parallel_for(thread_pool& pool, Index first, Index last, F&& fn) {
+    auto size = last > first ? static_cast<std::size_t>(last - first) : 0;
+    parallel_for(pool, first, last, detail::default_grain(pool, size), std::forward<F>(fn));
+}
+
+/// Call the function with every element of the range using the pool
+///
+/// \param grain The number of elements processed by a single task
+template <typename Range, typename F, typename = std::enable_if_t<!detail::is_index_v<Range>>>
+void parallel_for(thread_pool& pool, Range&& range, std::size_t grain, F&& fn) {
+    detail::chunked_range chunks(std::begin(range), std::end(range), grain);
+    auto chunk_fn = [&](std::size_t chunk) {
+        for (auto it = chunks.begin(chunk), end = chunks.end(chunk); it != end; ++it) {
+            fn(*it);
+        }
+    };
+    detail::parallel_invoke(pool, chunks.count(), chunk_fn);
+}
+
+/// Call the function with every element of the range using the pool
+template <typename Range, typename F, typename = std::enable_if_t<!detail::is_index_v<Range>>>
+void parallel_for(thread_pool& pool, Range&& range, F&& fn) {
+    auto size = static_cast<std::size_t>(std::distance(std::begin(range), std::end(range)));
+    parallel_for(pool, std::forward<Range>(range), detail::default_grain(pool, size), std::forward<F>(fn));
+}
+
+// parallel_reduce
+
+/// Reduce the elements of the range using the pool
+///
+/// Every chunk is reduced separately starting from the identity, then the
+/// partial results are combined in order on the calling thread.
+///
+/// \param grain The number of elements processed by a single task
+/// \param identity The identity element of the reduction (e.g. 0 for a sum)
+/// \param reduce Called with the accumulated value and an element
+/// \param combine Called with the accumulated value and a partial result
+template <typename Range, typename T, typename Reduce, typename Combine>
+T parallel_reduce(thread_pool& pool, Range&& range, std::size_t grain, T identity, Reduce&& reduce, Combine&& combine) {
+    detail::chunked_range chunks(std::begin(range), std::end(range), grain);
+    std::vector<T> partials(chunks.count(), identity);
+    auto chunk_fn = [&](std::size_t chunk) {
+        auto result = identity;
+        for (auto it = chunks.begin(chunk), end = chunks.end(chunk); it != end; ++it) {
+            result = reduce(std::move(result), *it);
+        }
+        partials[chunk] = std::move(result);
+    };
+    detail::parallel_invoke(pool, chunks.count(), chunk_fn);
+
+    auto result = std::move(identity);
+    for (auto& partial : partials) {
+        result = combine(std::move(result), std::move(partial));
+    }
+    return result;
+}
+
+/// Reduce the elements of the range using the pool
+///
+/// \note The reduction function is also used to combine the partial results.
+template <typename Range, typename T, typename Reduce>
+T parallel_reduce(thread_pool& pool, Range&& range, std::size_t grain, T identity, Reduce&& reduce) {
+    return parallel_reduce(pool, std::forward<Range>(range), grain, std::move(identity), reduce, reduce);
+}
+
+/// Reduce the elements of the range using the pool
+///
+/// \note The reduction function is also used to combine the partial results.
+template <typename Range, typename T, typename Reduce>
+T parallel_reduce(thread_pool& pool, Range&& range, T identity, Reduce&& reduce) {
+    auto size = static_cast<std::size_t>(std::distance(std::begin(range), std::end(range)));
+    return parallel_reduce(pool, std::forward<Range>(range), detail::default_grain(pool, size), std::move(identity), reduce);
+}
+
+// parallel_transform
+
+/// Store the result of the function called with every element of the range
+/// using the pool
+///
+/// \param out The beginning of the destination, must be a random access
+///            iterator with enough room for every element
+/// \param grain The number of elements processed by a single task
+///
+/// \return The iterator past the last element written
+template <typename Range, typename OutputIt, typename F>
+OutputIt parallel_transform(thread_pool& pool, Range&& range, OutputIt out, std::size_t grain, F&& fn) {
+    static_assert(detail::chunked_range<OutputIt>::is_random_access, "the output must be a random access iterator");
+    detail::chunked_range chunks(std::begin(range), std::end(range), grain);
+    auto chunk_fn = [&](std::size_t chunk) {
+        auto dest = std::next(out, static_cast<std::ptrdiff_t>(chunks.offset(chunk)));
+        std::transform(chunks.begin(chunk), chunks.end(chunk), dest, std::ref(fn));
+    };
+    detail::parallel_invoke(pool, chunks.count(), chunk_fn);
+    return std::next(out, static_cast<std::ptrdiff_t>(chunks.size()));
+}
+
+/// Store the result of the function called with every element of the range
+/// using the pool
+template <typename Range, typename OutputIt, typename F>
+OutputIt parallel_transform(thread_pool& pool, Range&& range, OutputIt out, F&& fn) {
+    auto size = static_cast<std::size_t>(std::distance(std::begin(range), std::end(range)));
+    return parallel_transform(pool, std::forward<Range>(range), out, detail::default_grain(pool, size), fn);
+}
+
+// parallel_sort
+
+/// Sort the elements using the pool
+///
+/// The range is split into a chunk per thread, the chunks are sorted in
+/// parallel and then merged pairwise in rounds, moving the elements between
+/// the range and a buffer of the same size. Every merge is split between the
+/// threads as well.
+///
+/// \note The sort is stable.
+template <typename RandomIt, typename Compare = std::less<>>
+void parallel_sort(thread_pool& pool, RandomIt first, RandomIt last, Compare comp = Compare()) {
+    using value_type = typename std::iterator_traits<RandomIt>::value_type;
+
+    // ranges smaller than this are sorted on the calling thread
+    constexpr std::size_t min_chunk_size = 2048;
+
+    auto size = static_cast<std::size_t>(std::distance(first, last));
+    auto grain = std::max(min_chunk_size, (size + pool.thread_count()) / (pool.thread_count() + 1));
+    if (size <= grain) {
+        std::stable_sort(first, last, comp);
+        return;
+    }
+
+    detail::chunked_range chunks(first, last, grain);
+    detail::sort_buffer<value_type> buffer(size, grain);
+
+    // the first round merges from the buffer
+    auto sort_fn = [&](std::size_t chunk) {
+        std::stable_sort(chunks.begin(chunk), chunks.end(chunk), comp);
+        buffer.construct(chunk, chunks.begin(chunk));
+    };
+    detail::parallel_invoke(pool, chunks.count(), sort_fn);
+
+    // the boundaries of the sorted runs
+    std::vector<std::size_t> bounds;
+    bounds.reserve(chunks.count() + 1);
+    for (std::size_t i = 0; i < chunks.count(); ++i) {
+        bounds.push_back(chunks.offset(i));
+    }
+    bounds.push_back(size);
+
+    // merge the adjacent runs until there is only a single one
+    auto is_in_buffer = true;
+    while (bounds.size() > 2) {
+        if (is_in_buffer) {
+            detail::merge_runs(pool, buffer.data(), first, bounds, grain, comp);
+        } else {
+            detail::merge_runs(pool, first, buffer.data(), bounds, grain, comp);
+        }
+        is_in_buffer = !is_in_buffer;
+
+        // every merged pair becomes a single run
+        std::vector<std::size_t> merged;
+        merged.reserve(bounds.size() / 2 + 2);
+        for (std::size_t i = 0; i < bounds.size(); i += 2) {
+            merged.push_back(bounds[i]);
+        }
+        if (merged.back() != size) {
+            merged.push_back(size);
+        }
+        bounds = std::move(merged);
+    }
+
+    if (is_in_buffer) {
+        auto move_fn = [&](std::size_t chunk) {
+            auto data = buffer.data() + chunks.offset(chunk);
+            std::move(data, data + std::distance(chunks.begin(chunk), chunks.end(chunk)), chunks.begin(chunk));
+        };
+        detail::parallel_invoke(pool, chunks.count(), move_fn);
+    }
+}
+
+} // namespace concurrency
+
+// bring symbols into parent namespace
+
+using concurrency::parallel_for;
+using concurrency::parallel_reduce;
+using concurrency::parallel_sort;
+using concurrency::parallel_transform;
+
+} // namespace shard
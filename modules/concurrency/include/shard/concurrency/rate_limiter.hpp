@@ -0,0 +1,222 @@
+// Copyright (c) 2026 Miklos Molnar. All rights reserved.
+
+#pragma once
+
+#include "shard/concurrency/sharded_thread_safe.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace shard {
+namespace concurrency {
+
+/// Lock-free token bucket limiting the rate of some operation
+///
+/// The whole state is a single atomic timestamp (the generic cell rate
+/// algorithm): the time at which the bucket would be full again. Acquiring
+/// permits pushes it forward by their cost, the request is allowed as long as
+/// it does not end up further in the future than the burst size allows.
+///
+/// \see "Generic cell rate algorithm"
+class rate_limiter {
+public:
+    using clock = std::chrono::steady_clock;
+
+public:
+    /// Create a new limiter allowing 'rate' permits per second, of which at
+    /// most 'burst' can be used at once
+    explicit rate_limiter(double rate, std::size_t burst = 1)
+    : m_interval(std::max<std::int64_t>(std::llround(1e9 / rate), 1))
+    , m_tolerance(m_interval * static_cast<std::int64_t>(burst))
+    , m_burst(burst) {
+        assert(rate > 0.0);
+        assert(burst > 0);
+    }
+
+    rate_limiter(const rate_limiter&) = delete;
+    rate_limiter& operator=(const rate_limiter&) = delete;
+
+    /// Acquire the permits if they are available
+    ///
+    /// \note It is safe to call this from multiple threads
+    ///
+    /// \return true if the permits were acquired, false otherwise
+    bool try_acquire(std::size_t count = 1) noexcept {
+        auto now = to_ns(clock::now());
+        auto cost = m_interval * static_cast<std::int64_t>(count);
+        auto tat = m_tat.load(std::memory_order_relaxed);
+        while (true) {
+            auto next = std::max(tat, now) + cost;
+            if (next - now > m_tolerance) {
+                return false;
+            }
+            if (m_tat.compare_exchange_weak(tat, next, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+    }
+
+    /// Acquire the permits, blocking the calling thread until they are
+    /// available
+    ///
+    /// \note It is safe to call this from multiple threads
+    void acquire(std::size_t count = 1) { std::this_thread::sleep_until(reserve(count)); }
+
+    /// Acquire the permits without waiting for them
+    ///
+    /// The permits are taken from the ones available in the future, so the
+    /// caller has to wait until the returned time before using them.
+    ///
+    /// \note It is safe to call this from multiple threads
+    ///
+    /// \return The time the permits become available
+    clock::time_point reserve(std::size_t count = 1) noexcept {
+        assert(count <= m_burst);
+        auto now = to_ns(clock::now());
+        auto cost = m_interval * static_cast<std::int64_t>(count);
+        auto tat = m_tat.load(std::memory_order_relaxed);
+        auto next = std::max(tat, now) + cost;
+        while (!m_tat.compare_exchange_weak(tat, next, std::memory_order_relaxed)) {
+            next = std::max(tat, now) + cost;
+        }
+        return clock::time_point(std::chrono::duration_cast<clock::duration>(
+            std::chrono::nanoseconds(std::max(next - m_tolerance, now))));
+    }
+
+    /// Check if the limiter has not been used for long enough to allow a full
+    /// burst again
+    bool is_idle() const noexcept { return m_tat.load(std::memory_order_relaxed) <= to_ns(clock::now()); }
+
+    /// Get the number of permits allowed per second
+    double rate() const noexcept { return 1e9 / static_cast<double>(m_interval); }
+
+    /// Get the number of permits that can be used at once
+    std::size_t burst() const noexcept { return m_burst; }
+
+private:
+    static std::int64_t to_ns(clock::time_point time) noexcept {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+    }
+
+private:
+    // the time between two permits and the time the bucket can be ahead
+    std::int64_t m_interval;
+    std::int64_t m_tolerance;
+    std::size_t m_burst;
+    // the theoretical arrival time, when the bucket is full again
+    std::atomic<std::int64_t> m_tat = ATOMIC_VAR_INIT(0);
+};
+
+/// Rate limiter with a separate bucket for every key
+///
+/// The buckets are created on first use and kept in a sharded map, the shards
+/// are only locked exclusively to add or remove keys.
+///
+/// \note Call 'prune()' periodically if the set of keys is not bounded.
+template <typename Key, std::size_t N = 16, typename Hash = std::hash<Key>>
+class keyed_rate_limiter {
+public:
+    using key_type = Key;
+
+public:
+    /// Create a new limiter allowing 'rate' permits per second for every key,
+    /// of which at most 'burst' can be used at once
+    explicit keyed_rate_limiter(double rate, std::size_t burst = 1)
+    : m_rate(rate)
+    , m_burst(burst) {}
+
+    /// Acquire the permits of the key if they are available
+    ///
+    /// \note It is safe to call this from multiple threads
+    ///
+    /// \return true if the permits were acquired, false otherwise
+    bool try_acquire(const key_type& key, std::size_t count = 1) {
+        return with_limiter(key, [count](rate_limiter& limiter) { return limiter.try_acquire(count); });
+    }
+
+    /// Acquire the permits of the key, blocking the calling thread until they
+    /// are available
+    ///
+    /// \note It is safe to call this from multiple threads
+    void acquire(const key_type& key, std::size_t count = 1) {
+        // only reserve under the lock, the wait does not hold up the shard
+        auto time = with_limiter(key, [count](rate_limiter& limiter) { return limiter.reserve(count); });
+        std::this_thread::sleep_until(time);
+    }
+
+    /// Remove the keys whose limiters are idle, which behave the same as new
+    /// ones
+    ///
+    /// \return The number of keys removed
+    std::size_t prune() {
+        std::size_t count = 0;
+        m_limiters.for_each_shard([&count](map_type& limiters) {
+            for (auto it = limiters.begin(); it != limiters.end();) {
+                if (it->second->is_idle()) {
+                    it = limiters.erase(it);
+                    ++count;
+                } else {
+                    ++it;
+                }
+            }
+        });
+        return count;
+    }
+
+    /// Get the number of keys with a limiter
+    ///
+    /// \note The shards are counted one after the other, so this is only an
+    ///       approximation while other threads are adding keys.
+    std::size_t size() const {
+        std::size_t count = 0;
+        m_limiters.for_each_shard([&count](const map_type& limiters) { count += limiters.size(); });
+        return count;
+    }
+
+private:
+    // the limiters are not movable, so they are kept on the heap
+    using map_type = std::unordered_map<Key, std::unique_ptr<rate_limiter>, Hash>;
+
+private:
+    // call the function with the limiter of the key, creating it if needed
+    template <typename F>
+    auto with_limiter(const key_type& key, F&& fn) {
+        {
+            auto limiters = m_limiters.read_access(key);
+            auto it = limiters->find(key);
+            if (it != limiters->end()) {
+                return fn(*it->second);
+            }
+        }
+        auto limiters = m_limiters.write_access(key);
+        auto& limiter = (*limiters)[key];
+        if (!limiter) {
+            limiter = std::make_unique<rate_limiter>(m_rate, m_burst);
+        }
+        return fn(*limiter);
+    }
+
+private:
+    double m_rate;
+    std::size_t m_burst;
+    sharded_thread_safe<map_type, N, std::shared_mutex, Hash> m_limiters;
+};
+
+} // namespace concurrency
+
+// bring symbols into parent namespace
+
+using concurrency::keyed_rate_limiter;
+using concurrency::rate_limiter;
+
+} // namespace shard
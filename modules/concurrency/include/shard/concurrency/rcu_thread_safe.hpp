@@ -0,0 +1,149 @@
+// Copyright (c) 2026 Miklos Molnar. All rights reserved.
+
+#pragma once
+
+#include "shard/concurrency/detail/epoch_domain.hpp"
+#include "shard/concurrency/lock_traits.hpp"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <type_traits>
+#include <utility>
+
+namespace shard {
+namespace concurrency {
+
+/// Thread-safe wrapper for read-mostly values with wait-free reads
+///
+/// Readers access the current version of the value without taking any lock.
+/// Writers are serialized, they modify a copy of the value and publish it when
+/// done, the previous version is destroyed through epoch-based reclamation
+/// once no reader can access it anymore.
+///
+/// The access API is the same as 'basic_thread_safe', so it can replace it for
+/// values that are rarely modified (e.g. lookup tables).
+///
+/// \note Every write copies the whole value.
+template <typename T>
+class rcu_thread_safe {
+public:
+    using mutex_type = std::mutex;
+    using value_type = std::decay_t<T>;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+
+private:
+    /// Wait-free read-only access to the current version
+    class reader {
+    public:
+        using pointer = const value_type*;
+        using const_pointer = const value_type*;
+        using reference = const value_type&;
+        using const_reference = const value_type&;
+
+    public:
+        reader(const rcu_thread_safe& value) /* NOLINT */
+        : m_guard(detail::epoch_domain::global().pin())
+        , m_pointer(value.m_current.load(std::memory_order_seq_cst)) {}
+
+        const_pointer operator->() const noexcept { return m_pointer; }
+
+        const_reference operator*() const noexcept { return *m_pointer; }
+
+    private:
+        detail::epoch_domain::guard m_guard;
+        pointer m_pointer;
+    };
+
+    /// Exclusive access to a copy of the current version, published when the
+    /// access is destroyed
+    template <template <typename> class Lock>
+    class writer {
+    public:
+        using lock_type = Lock<mutex_type>;
+        using pointer = value_type*;
+        using const_pointer = const value_type*;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+
+    public:
+        writer(rcu_thread_safe& value) /* NOLINT */
+        : m_lock(value.m_mutex)
+        , m_owner(value)
+        , m_copy(std::make_unique<value_type>(*value.m_current.load(std::memory_order_relaxed))) {}
+
+        writer(const writer&) = delete;
+        writer& operator=(const writer&) = delete;
+
+        ~writer() { m_owner.publish(m_copy.release()); }
+
+        pointer operator->() noexcept { return m_copy.get(); }
+
+        const_pointer operator->() const noexcept { return m_copy.get(); }
+
+        reference operator*() noexcept { return *m_copy; }
+
+        const_reference operator*() const noexcept { return *m_copy; }
+
+    private:
+        lock_type m_lock;
+        rcu_thread_safe& m_owner;
+        std::unique_ptr<value_type> m_copy;
+    };
+
+public:
+    /// \note The lock is not used by readers, it is only kept for
+    ///       compatibility with 'basic_thread_safe'.
+    template <template <typename> class Lock = read_lock>
+    using read_access = reader;
+
+    template <template <typename> class Lock = std::lock_guard>
+    using write_access = writer<Lock>;
+
+public:
+    /// Default constructor
+    rcu_thread_safe()
+    : m_current(new value_type()) {}
+
+    rcu_thread_safe(const rcu_thread_safe&) = delete;
+    rcu_thread_safe(rcu_thread_safe&&) = delete;
+
+    template <typename... Args>
+    explicit rcu_thread_safe(Args&&... args)
+    : m_current(new value_type(std::forward<Args>(args)...)) {}
+
+    /// Destroy the current version
+    ///
+    /// \warning There must be no readers left
+    ~rcu_thread_safe() { delete m_current.load(std::memory_order_relaxed); }
+
+    rcu_thread_safe& operator=(const rcu_thread_safe&) = delete;
+    rcu_thread_safe& operator=(rcu_thread_safe&&) = delete;
+
+    /// Get an unsafe const reference to the current version
+    const_reference unsafe() const noexcept { return *m_current.load(std::memory_order_acquire); }
+
+    /// Get a reference to the mutex serializing the writers
+    mutex_type& mutex() const noexcept { return m_mutex; }
+
+private:
+    // make the new version visible and retire the previous one
+    void publish(value_type* value) {
+        auto previous = m_current.exchange(value, std::memory_order_seq_cst);
+        detail::epoch_domain::global().retire(previous, [](void* p) { delete static_cast<value_type*>(p); });
+    }
+
+private:
+    std::atomic<value_type*> m_current;
+    mutable mutex_type m_mutex;
+};
+
+} // namespace concurrency
+
+// bring symbols into parent namespace
+
+using concurrency::rcu_thread_safe;
+
+} // namespace shard
@@ -0,0 +1,102 @@
+// Copyright (c) 2026 Miklos Molnar. All rights reserved.
+
+#pragma once
+
+#include "shard/concurrency/detail/backoff.hpp"
+#include "shard/concurrency/lock_traits.hpp"
+
+#include <shard/utility/non_copyable.hpp>
+
+#include <atomic>
+#include <cstdint>
+
+namespace shard {
+namespace concurrency {
+
+/// Reader-writer mutex busy waiting in user space
+///
+/// The state is a single word holding the number of readers and the writer
+/// flags. A waiting writer stops new readers from entering, so writers are not
+/// starved by a continuous stream of readers.
+///
+/// \warning Waiting threads never block, avoid it when the lock might be held
+///          for long or by more threads than there are cores.
+class rw_spin_mutex : private utility::non_copyable {
+public:
+    rw_spin_mutex() = default;
+
+    rw_spin_mutex(rw_spin_mutex&&) = delete;
+    rw_spin_mutex& operator=(rw_spin_mutex&&) = delete;
+
+    void lock() noexcept {
+        detail::exponential_backoff backoff;
+        auto state = m_state.load(std::memory_order_relaxed);
+        while (true) {
+            if ((state & ~writer_pending) == 0) {
+                // taking the lock clears the pending flag, the other waiting
+                // writers set it again
+                if (m_state.compare_exchange_weak(state, writer, std::memory_order_acquire, std::memory_order_relaxed)) {
+                    return;
+                }
+                continue;
+            }
+            if ((state & writer_pending) == 0) {
+                m_state.fetch_or(writer_pending, std::memory_order_relaxed);
+            }
+            backoff.pause();
+            state = m_state.load(std::memory_order_relaxed);
+        }
+    }
+
+    void unlock() noexcept { m_state.fetch_and(~writer, std::memory_order_release); }
+
+    bool try_lock() noexcept {
+        auto state = m_state.load(std::memory_order_relaxed);
+        return (state & ~writer_pending) == 0
+               && m_state.compare_exchange_strong(state, writer, std::memory_order_acquire, std::memory_order_relaxed);
+    }
+
+    void lock_shared() noexcept {
+        detail::exponential_backoff backoff;
+        while (!try_lock_shared()) {
+            do {
+                backoff.pause();
+            } while (m_state.load(std::memory_order_relaxed) & (writer | writer_pending));
+        }
+    }
+
+    void unlock_shared() noexcept { m_state.fetch_sub(reader, std::memory_order_release); }
+
+    bool try_lock_shared() noexcept {
+        auto state = m_state.load(std::memory_order_relaxed);
+        // only fail because of writers, not other readers entering or leaving
+        while ((state & (writer | writer_pending)) == 0) {
+            if (m_state.compare_exchange_weak(state, state + reader, std::memory_order_acquire,
+                                              std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    static constexpr std::uint32_t writer = 1;
+    static constexpr std::uint32_t writer_pending = 2;
+    static constexpr std::uint32_t reader = 4;
+
+private:
+    std::atomic<std::uint32_t> m_state = ATOMIC_VAR_INIT(0);
+};
+
+template <>
+struct mutex_traits<rw_spin_mutex> {
+    static constexpr bool is_shared = true;
+};
+
+} // namespace concurrency
+
+// bring symbols into parent namespace
+
+using concurrency::rw_spin_mutex;
+
+} // namespace shard
@@ -0,0 +1,117 @@
+// Copyright (c) 2026 Miklos Molnar. All rights reserved.
+
+#pragma once
+
+#include "shard/concurrency/channel.hpp"
+#include "shard/concurrency/detail/select_waiter.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <optional>
+
+namespace shard {
+namespace concurrency {
+namespace detail {
+
+/// Implementation of select() with access to the waiter registration of the
+/// channels
+class selector {
+public:
+    template <typename TimePoint, typename... Ts>
+    static std::optional<std::size_t> wait(const TimePoint* time, channel<Ts>&... channels) {
+        // check before registering, most of the time a channel is ready
+        if (auto result = poll(channels...)) {
+            return result;
+        }
+
+        select_waiter waiter;
+        std::array<select_link, sizeof...(Ts)> links;
+        for (auto& link : links) {
+            link.waiter = &waiter;
+        }
+        auto link = links.data();
+        (channels.add_waiter(link++), ...);
+
+        std::optional<std::size_t> result;
+        while (true) {
+            // a channel signaling after the registration wakes the waiter, so
+            // nothing is missed between polling and waiting
+            if (result = poll(channels...); result || all_closed(channels...)) {
+                break;
+            }
+            if (!waiter.wait(time)) {
+                result = poll(channels...);
+                break;
+            }
+        }
+
+        link = links.data();
+        (channels.remove_waiter(link++), ...);
+        return result;
+    }
+
+    // get the index of the first channel that is open and has an item
+    template <typename... Ts>
+    static std::optional<std::size_t> poll(channel<Ts>&... channels) {
+        std::optional<std::size_t> result;
+        std::size_t index = 0;
+        auto check = [&](auto& c) {
+            if (!result && c.is_open() && !c.is_empty()) {
+                result = index;
+            }
+            ++index;
+        };
+        (check(channels), ...);
+        return result;
+    }
+
+    template <typename... Ts>
+    static bool all_closed(channel<Ts>&... channels) {
+        return (!channels.is_open() && ...);
+    }
+};
+
+} // namespace detail
+
+/// Block the calling thread until one of the channels has an item
+///
+/// The calling thread registers a single waiter with every channel, so
+/// watching several channels takes only one thread and one wake-up.
+///
+/// \note The channels are checked in order, so earlier channels take priority
+///       when more than one is ready. The item is not popped, another consumer
+///       might take it before the caller does.
+///
+/// \return The index of a channel that is ready or nullopt if all of them are
+///         closed
+template <typename... Ts>
+std::optional<std::size_t> select(channel<Ts>&... channels) {
+    static_assert(sizeof...(Ts) > 0, "at least one channel is required");
+    return detail::selector::wait<std::chrono::steady_clock::time_point>(nullptr, channels...);
+}
+
+/// Block the calling thread until one of the channels has an item or the
+/// timeout has elapsed
+///
+/// \note The channels are checked in order, so earlier channels take priority
+///       when more than one is ready. The item is not popped, another consumer
+///       might take it before the caller does.
+///
+/// \return The index of a channel that is ready or nullopt if all of them are
+///         closed or the timeout has elapsed
+template <typename Rep, typename Period, typename... Ts>
+std::optional<std::size_t> select_for(const std::chrono::duration<Rep, Period>& timeout, channel<Ts>&... channels) {
+    static_assert(sizeof...(Ts) > 0, "at least one channel is required");
+    auto time = std::chrono::steady_clock::now() + timeout;
+    return detail::selector::wait(&time, channels...);
+}
+
+} // namespace concurrency
+
+// bring symbols into parent namespace
+
+using concurrency::select;
+using concurrency::select_for;
+
+} // namespace shard
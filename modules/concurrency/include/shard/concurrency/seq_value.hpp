@@ -0,0 +1,122 @@
+// Copyright (c) 2026 Miklos Molnar. All rights reserved.
+
+#pragma once
+
+#include "shard/concurrency/detail/backoff.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace shard {
+namespace concurrency {
+
+/// Value published by writers and read by any number of readers without locks
+///
+/// A sequence number is incremented before and after every store, readers
+/// copy the value and retry if the number changed in the meantime. The value
+/// is kept in atomic words, so a torn copy is discarded without ever being a
+/// data race.
+///
+/// \note Loading never blocks the writers, but readers retry as long as a
+///       store is in progress. It works best for small values that are read
+///       far more often than written.
+template <typename T>
+class seq_value {
+    static_assert(std::is_trivially_copyable_v<T>, "seq_value requires a trivially copyable type");
+    static_assert(std::is_default_constructible_v<T>, "seq_value requires a default constructible type");
+
+public:
+    using value_type = T;
+
+public:
+    /// Create a value initialized with the default value
+    seq_value()
+    : seq_value(value_type {}) {}
+
+    /// Create a value initialized with the given value
+    explicit seq_value(const value_type& value) { write(value); }
+
+    seq_value(const seq_value&) = delete;
+    seq_value& operator=(const seq_value&) = delete;
+
+    /// Get a consistent copy of the value
+    ///
+    /// \note It is safe to call this from multiple threads
+    value_type load() const noexcept {
+        value_type result;
+        while (!try_load(result)) {
+            detail::cpu_relax();
+        }
+        return result;
+    }
+
+    /// Try to get a consistent copy of the value once
+    ///
+    /// \note It is safe to call this from multiple threads
+    ///
+    /// \return true if the copy is consistent, false if a store was in progress
+    bool try_load(value_type& out) const noexcept {
+        auto before = m_sequence.load(std::memory_order_acquire);
+        if ((before & 1) != 0) {
+            return false;
+        }
+        word_type words[word_count];
+        for (std::size_t i = 0; i < word_count; ++i) {
+            words[i] = m_words[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_sequence.load(std::memory_order_relaxed) != before) {
+            return false;
+        }
+        std::memcpy(&out, words, sizeof(value_type));
+        return true;
+    }
+
+    /// Replace the value
+    ///
+    /// \note It is safe to call this from multiple threads, the writers are
+    ///       serialized by the sequence number.
+    void store(const value_type& value) noexcept {
+        auto sequence = m_sequence.load(std::memory_order_relaxed);
+        while (true) {
+            if ((sequence & 1) == 0
+                && m_sequence.compare_exchange_weak(sequence, sequence + 1, std::memory_order_relaxed)) {
+                break;
+            }
+            detail::cpu_relax();
+            sequence = m_sequence.load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+        write(value);
+        m_sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+private:
+    using word_type = std::uintptr_t;
+
+    static constexpr std::size_t word_count = (sizeof(value_type) + sizeof(word_type) - 1) / sizeof(word_type);
+
+private:
+    void write(const value_type& value) noexcept {
+        word_type words[word_count] = {};
+        std::memcpy(words, &value, sizeof(value_type));
+        for (std::size_t i = 0; i < word_count; ++i) {
+            m_words[i].store(words[i], std::memory_order_relaxed);
+        }
+    }
+
+private:
+    std::atomic<std::uint64_t> m_sequence = ATOMIC_VAR_INIT(0);
+    std::atomic<word_type> m_words[word_count];
+};
+
+} // namespace concurrency
+
+// bring symbols into parent namespace
+
+using concurrency::seq_value;
+
+} // namespace shard
@@ -0,0 +1,116 @@
+// Copyright (c) 2026 Miklos Molnar. All rights reserved.
+
+#pragma once
+
+#include "shard/concurrency/cache_line.hpp"
+#include "shard/concurrency/thread_safe.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <shared_mutex>
+
+namespace shard {
+namespace concurrency {
+
+/// Thread-safe wrapper for associative containers partitioned into shards
+///
+/// The keys are hashed to one of the shards, each with its own mutex, so
+/// threads accessing different shards do not contend. The shards are padded
+/// to separate cache lines.
+///
+/// \note Every key must only be accessed through its own shard, use the key
+///       based access functions to get to the right one.
+template <typename Map,
+          std::size_t N,
+          typename Mutex = std::shared_mutex,
+          typename Hash = std::hash<typename Map::key_type>>
+class sharded_thread_safe {
+    static_assert(N > 0, "at least one shard is required");
+
+public:
+    using map_type = Map;
+    using key_type = typename Map::key_type;
+    using mutex_type = Mutex;
+    using shard_type = basic_thread_safe<Map, Mutex>;
+
+public:
+    sharded_thread_safe() = default;
+
+    sharded_thread_safe(const sharded_thread_safe&) = delete;
+    sharded_thread_safe& operator=(const sharded_thread_safe&) = delete;
+
+    /// Get read-only access to the shard of the key
+    template <template <typename> class Lock = read_lock>
+    typename shard_type::template read_access<Lock> read_access(const key_type& key) const {
+        return {shard_of(key)};
+    }
+
+    /// Get read-write access to the shard of the key
+    template <template <typename> class Lock = std::lock_guard>
+    typename shard_type::template write_access<Lock> write_access(const key_type& key) {
+        return {shard_of(key)};
+    }
+
+    /// Call the function with every shard, locking one at a time
+    ///
+    /// \note The function is not given a consistent view of the whole map,
+    ///       the other shards can be modified in the meantime.
+    template <typename F>
+    void for_each_shard(F&& fn) {
+        for (auto& s : m_shards) {
+            typename shard_type::template write_access<> access(s.value);
+            fn(*access);
+        }
+    }
+
+    /// Call the function with every shard, locking one at a time for reading
+    ///
+    /// \note The function is not given a consistent view of the whole map,
+    ///       the other shards can be modified in the meantime.
+    template <typename F>
+    void for_each_shard(F&& fn) const {
+        for (auto& s : m_shards) {
+            typename shard_type::template read_access<> access(s.value);
+            fn(*access);
+        }
+    }
+
+    /// Get the index of the shard the key belongs to
+    std::size_t shard_index(const key_type& key) const {
+        // mix the bits as the hash of integers is often the identity
+        auto hash = static_cast<std::uint64_t>(m_hash(key)) * 0x9e3779b97f4a7c15ull;
+        return static_cast<std::size_t>((hash >> 32) % N);
+    }
+
+    /// Get the shard with the given index
+    shard_type& shard(std::size_t index) noexcept { return m_shards[index].value; }
+
+    /// Get the shard with the given index
+    const shard_type& shard(std::size_t index) const noexcept { return m_shards[index].value; }
+
+    /// Get the number of shards
+    static constexpr std::size_t shard_count() noexcept { return N; }
+
+private:
+    struct alignas(cache_line_size) padded_shard {
+        shard_type value;
+    };
+
+private:
+    shard_type& shard_of(const key_type& key) { return m_shards[shard_index(key)].value; }
+
+    const shard_type& shard_of(const key_type& key) const { return m_shards[shard_index(key)].value; }
+
+private:
+    padded_shard m_shards[N];
+    Hash m_hash;
+};
+
+} // namespace concurrency
+
+// bring symbols into parent namespace
+
+using concurrency::sharded_thread_safe;
+
+} // namespace shard
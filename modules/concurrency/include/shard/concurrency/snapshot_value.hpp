@@ -0,0 +1,144 @@
+// Copyright (c) 2026 Miklos Molnar. All rights reserved.
+
+#pragma once
+
+#include "shard/concurrency/cache_line.hpp"
+#include "shard/concurrency/detail/backoff.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace shard {
+namespace concurrency {
+
+/// Value published by a single writer and read in-place by multiple readers
+///
+/// A generalization of 'tbuf_value' with a slot for every reader, one for the
+/// latest value and one for the writer. Readers pin the latest slot with a
+/// reference count and read it without copying, the writer always finds an
+/// unpinned slot to write the next value to.
+///
+/// \warning At most 'Readers' views may be held at the same time and a thread
+///          must release its view before getting a new one.
+template <typename T, std::size_t Readers>
+class snapshot_value {
+    static_assert(Readers > 0, "at least one reader is required");
+
+    struct slot;
+
+public:
+    using value_type = T;
+
+    /// Read-only view of the value, the slot it refers to is not reused until
+    /// the view is destroyed
+    class view {
+        friend class snapshot_value;
+
+    public:
+        view(const view&) = delete;
+
+        view(view&& other) noexcept
+        : m_slot(std::exchange(other.m_slot, nullptr)) {}
+
+        ~view() { release(); }
+
+        view& operator=(const view&) = delete;
+
+        view& operator=(view&& other) noexcept {
+            if (this != &other) {
+                release();
+                m_slot = std::exchange(other.m_slot, nullptr);
+            }
+            return *this;
+        }
+
+        const value_type& get() const noexcept { return m_slot->value; }
+
+        const value_type& operator*() const noexcept { return get(); }
+
+        const value_type* operator->() const noexcept { return &get(); }
+
+    private:
+        explicit view(const slot* s) noexcept
+        : m_slot(s) {}
+
+        void release() noexcept {
+            if (m_slot) {
+                m_slot->refs.fetch_sub(1, std::memory_order_release);
+                m_slot = nullptr;
+            }
+        }
+
+    private:
+        const slot* m_slot;
+    };
+
+public:
+    /// Create a value initialized with the default value
+    snapshot_value() = default;
+
+    /// Create a value initialized with the given value
+    explicit snapshot_value(const value_type& value) { m_slots[0].value = value; }
+
+    snapshot_value(const snapshot_value&) = delete;
+    snapshot_value& operator=(const snapshot_value&) = delete;
+
+    /// Get a view of the latest value
+    ///
+    /// \note It is safe to call this from multiple threads
+    view load() const noexcept {
+        while (true) {
+            auto index = m_latest.load(std::memory_order_seq_cst);
+            auto& s = m_slots[index];
+            s.refs.fetch_add(1, std::memory_order_seq_cst);
+            // the writer might have picked the slot before it was pinned, it
+            // is only safe to read if it is still the latest
+            if (m_latest.load(std::memory_order_seq_cst) == index) {
+                return view(&s);
+            }
+            s.refs.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    /// Replace the value by perfect forwarding it
+    ///
+    /// \warning It is *NOT* safe to call this from multiple threads
+    template <typename U>
+    void store(U&& value) {
+        auto latest = m_latest.load(std::memory_order_relaxed);
+        auto index = latest;
+        do {
+            index = (index + 1) % slot_count;
+            if (index == latest) {
+                // every slot is pinned, more views are held than allowed
+                detail::cpu_relax();
+            }
+        } while (index == latest || m_slots[index].refs.load(std::memory_order_seq_cst) != 0);
+
+        m_slots[index].value = std::forward<U>(value);
+        m_latest.store(index, std::memory_order_seq_cst);
+    }
+
+private:
+    struct alignas(cache_line_size) slot {
+        mutable std::atomic<std::uint32_t> refs = ATOMIC_VAR_INIT(0);
+        value_type value {};
+    };
+
+    static constexpr std::size_t slot_count = Readers + 2;
+
+private:
+    slot m_slots[slot_count];
+    std::atomic<std::size_t> m_latest = ATOMIC_VAR_INIT(0);
+};
+
+} // namespace concurrency
+
+// bring symbols into parent namespace
+
+using concurrency::snapshot_value;
+
+} // namespace shard
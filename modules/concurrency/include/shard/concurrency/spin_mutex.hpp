@@ -0,0 +1,54 @@
+// Copyright (c) 2026 Miklos Molnar. All rights reserved.
+
+#pragma once
+
+#include "shard/concurrency/detail/backoff.hpp"
+
+#include <shard/utility/non_copyable.hpp>
+
+#include <atomic>
+
+namespace shard {
+namespace concurrency {
+
+/// Mutex busy waiting in user space, for very short critical sections
+///
+/// Test-and-test-and-set lock, waiting threads only read the flag until it is
+/// released so the cache line is not bounced between them, and back off
+/// exponentially between attempts.
+///
+/// \warning Waiting threads never block, avoid it when the lock might be held
+///          for long or by more threads than there are cores.
+class spin_mutex : private utility::non_copyable {
+public:
+    spin_mutex() = default;
+
+    spin_mutex(spin_mutex&&) = delete;
+    spin_mutex& operator=(spin_mutex&&) = delete;
+
+    void lock() noexcept {
+        detail::exponential_backoff backoff;
+        while (m_locked.exchange(true, std::memory_order_acquire)) {
+            do {
+                backoff.pause();
+            } while (m_locked.load(std::memory_order_relaxed));
+        }
+    }
+
+    void unlock() noexcept { m_locked.store(false, std::memory_order_release); }
+
+    bool try_lock() noexcept {
+        return !m_locked.load(std::memory_order_relaxed) && !m_locked.exchange(true, std::memory_order_acquire);
+    }
+
+private:
+    std::atomic<bool> m_locked = ATOMIC_VAR_INIT(false);
+};
+
+} // namespace concurrency
+
+// bring symbols into parent namespace
+
+using concurrency::spin_mutex;
+
+} // namespace shard
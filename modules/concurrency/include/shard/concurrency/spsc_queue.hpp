@@ -0,0 +1,324 @@
+// Copyright (c) 2026 Miklos Molnar. All rights reserved.
+
+#pragma once
+
+#include "shard/concurrency/cache_line.hpp"
+
+#include <shard/utility/span.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace shard {
+namespace concurrency {
+namespace detail {
+
+/// Ring buffer shared by a single producer and a single consumer
+///
+/// Both sides keep a local copy of the other side's index and only reload it
+/// when the copy says the buffer is full (or empty), so in the common case
+/// neither side touches the other's cache line.
+template <typename T>
+class spsc_queue_base {
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+
+public:
+    /// Create a queue holding at least 'capacity' items
+    ///
+    /// \note The capacity is rounded up to the next power of 2
+    explicit spsc_queue_base(size_type capacity)
+    : m_capacity(round_up(capacity))
+    , m_mask(m_capacity - 1)
+    , m_data(std::allocator<value_type>().allocate(m_capacity)) {}
+
+    spsc_queue_base(const spsc_queue_base&) = delete;
+    spsc_queue_base& operator=(const spsc_queue_base&) = delete;
+
+    /// Destroy the items still in the queue
+    ~spsc_queue_base() {
+        if constexpr (!std::is_trivially_destructible_v<value_type>) {
+            auto head = m_head.load(std::memory_order_acquire);
+            for (auto tail = m_tail.load(std::memory_order_relaxed); tail != head; ++tail) {
+                m_data[tail & m_mask].~value_type();
+            }
+        }
+        std::allocator<value_type>().deallocate(m_data, m_capacity);
+    }
+
+    /// Add a new item to the queue by copying it
+    ///
+    /// \warning Must only be called by the producer thread
+    ///
+    /// \return true if the item was added, false if the queue was full
+    bool try_push(const value_type& value) { return try_emplace(value); }
+
+    /// Add a new item to the queue by moving it
+    ///
+    /// \warning Must only be called by the producer thread
+    ///
+    /// \return true if the item was added, false if the queue was full
+    bool try_push(value_type&& value) { return try_emplace(std::move(value)); }
+
+    /// Add a new item to the queue by creating it in-place
+    ///
+    /// \warning Must only be called by the producer thread
+    ///
+    /// \return true if the item was added, false if the queue was full
+    template <typename... Args>
+    bool try_emplace(Args&&... args) {
+        auto head = m_head.load(std::memory_order_relaxed);
+        if (free_space(head) == 0) {
+            return false;
+        }
+        new (&m_data[head & m_mask]) value_type(std::forward<Args>(args)...);
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Pop and retrieve the next item from the queue
+    ///
+    /// \warning Must only be called by the consumer thread
+    ///
+    /// \return The item or nullopt if the queue was empty
+    std::optional<value_type> try_pop() {
+        auto tail = m_tail.load(std::memory_order_relaxed);
+        if (available(tail) == 0) {
+            return std::nullopt;
+        }
+        auto& item = m_data[tail & m_mask];
+        auto result = std::make_optional(std::move(item));
+        item.~value_type();
+        m_tail.store(tail + 1, std::memory_order_release);
+        return result;
+    }
+
+    /// Pop and retrieve the next item from the queue
+    ///
+    /// \warning Must only be called by the consumer thread
+    ///
+    /// \param out The reference to be assigned the value
+    ///
+    /// \return true if an item was retrieved, false if the queue was empty
+    bool try_pop(value_type& out) {
+        auto tail = m_tail.load(std::memory_order_relaxed);
+        if (available(tail) == 0) {
+            return false;
+        }
+        auto& item = m_data[tail & m_mask];
+        out = std::move(item);
+        item.~value_type();
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Copy as many items to the queue as there is room for
+    ///
+    /// The items are published to the consumer all at once.
+    ///
+    /// \warning Must only be called by the producer thread
+    ///
+    /// \return The number of items written
+    size_type write(span<const value_type> values) {
+        auto head = m_head.load(std::memory_order_relaxed);
+        auto count = std::min(values.size(), free_space(head, values.size()));
+        auto first = std::min(count, m_capacity - (head & m_mask));
+        copy_to(&m_data[head & m_mask], values.data(), first);
+        copy_to(m_data, values.data() + first, count - first);
+        m_head.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    /// Move as many items from the queue as there is room for
+    ///
+    /// If assigning an item throws, the items moved before it are removed
+    /// from the queue, the rest are kept.
+    ///
+    /// \warning Must only be called by the consumer thread
+    ///
+    /// \return The number of items read
+    size_type read(span<value_type> out) {
+        auto tail = m_tail.load(std::memory_order_relaxed);
+        auto count = std::min(out.size(), available(tail, out.size()));
+        auto first = std::min(count, m_capacity - (tail & m_mask));
+        size_type moved = 0;
+        try {
+            move_from(out.data(), &m_data[tail & m_mask], first, moved);
+            move_from(out.data() + first, m_data, count - first, moved);
+        } catch (...) {
+            // the items moved so far are destroyed, so they must leave the
+            // queue
+            m_tail.store(tail + moved, std::memory_order_release);
+            throw;
+        }
+        m_tail.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    /// Check if the queue is empty
+    ///
+    /// \note The result is only an approximation when used concurrently
+    bool is_empty() const noexcept { return size() == 0; }
+
+    /// Get the number of items in the queue
+    ///
+    /// \note The result is only an approximation when used concurrently
+    size_type size() const noexcept {
+        auto tail = m_tail.load(std::memory_order_acquire);
+        auto head = m_head.load(std::memory_order_acquire);
+        return head - tail;
+    }
+
+    /// Get the maximum number of items in the queue
+    size_type capacity() const noexcept { return m_capacity; }
+
+protected:
+    static size_type round_up(size_type capacity) {
+        size_type result = 2;
+        while (result < capacity) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    // get the free space seen by the producer, only reloading the consumer's
+    // index if there is less than 'needed'
+    size_type free_space(size_type head, size_type needed = 1) {
+        auto result = m_capacity - (head - m_cached_tail);
+        if (result < needed) {
+            m_cached_tail = m_tail.load(std::memory_order_acquire);
+            result = m_capacity - (head - m_cached_tail);
+        }
+        return result;
+    }
+
+    // get the number of items seen by the consumer, only reloading the
+    // producer's index if there are less than 'needed'
+    size_type available(size_type tail, size_type needed = 1) {
+        auto result = m_cached_head - tail;
+        if (result < needed) {
+            m_cached_head = m_head.load(std::memory_order_acquire);
+            result = m_cached_head - tail;
+        }
+        return result;
+    }
+
+    static void copy_to(value_type* dest, const value_type* src, size_type count) {
+        if constexpr (std::is_trivially_copyable_v<value_type>) {
+            if (count != 0) {
+                std::memcpy(dest, src, count * sizeof(value_type));
+            }
+        } else {
+            std::uninitialized_copy_n(src, count, dest);
+        }
+    }
+
+    // move the items out and destroy them, counting them in 'moved'
+    static void move_from(value_type* dest, value_type* src, size_type count, size_type& moved) {
+        if constexpr (std::is_trivially_copyable_v<value_type>) {
+            if (count != 0) {
+                std::memcpy(dest, src, count * sizeof(value_type));
+            }
+            moved += count;
+        } else {
+            for (size_type i = 0; i < count; ++i, ++moved) {
+                dest[i] = std::move(src[i]);
+                src[i].~value_type();
+            }
+        }
+    }
+
+protected:
+    const size_type m_capacity;
+    const size_type m_mask;
+    value_type* m_data;
+
+    // written by the producer
+    alignas(cache_line_size) std::atomic<size_type> m_head = ATOMIC_VAR_INIT(0);
+    size_type m_cached_tail = 0;
+
+    // written by the consumer
+    alignas(cache_line_size) std::atomic<size_type> m_tail = ATOMIC_VAR_INIT(0);
+    size_type m_cached_head = 0;
+};
+
+} // namespace detail
+
+/// Wait-free single-producer single-consumer queue
+template <typename T>
+class spsc_queue : public detail::spsc_queue_base<T> {
+public:
+    using detail::spsc_queue_base<T>::spsc_queue_base;
+};
+
+/// Wait-free single-producer single-consumer byte ring
+///
+/// Besides copying, the ring can be accessed in-place: the producer can write
+/// directly into the free region and the consumer can read directly from the
+/// filled region (e.g. by passing them to 'recv()' and 'send()').
+template <>
+class spsc_queue<std::byte> : public detail::spsc_queue_base<std::byte> {
+public:
+    using spsc_queue_base::spsc_queue_base;
+
+    /// Get the contiguous free region after the last written byte
+    ///
+    /// \note The region might be smaller than the free space if it wraps
+    ///       around, call this again after committing to get the rest.
+    ///
+    /// \warning Must only be called by the producer thread
+    span<std::byte> write_region() {
+        auto head = m_head.load(std::memory_order_relaxed);
+        auto offset = head & m_mask;
+        auto size = std::min(free_space(head, m_capacity - offset), m_capacity - offset);
+        return {m_data + offset, size};
+    }
+
+    /// Publish the bytes written to the region to the consumer
+    ///
+    /// \warning Must only be called by the producer thread
+    void commit_write(size_type count) {
+        auto head = m_head.load(std::memory_order_relaxed);
+        assert(count <= m_capacity - (head - m_cached_tail));
+        m_head.store(head + count, std::memory_order_release);
+    }
+
+    /// Get the contiguous region of bytes ready to be read
+    ///
+    /// \note The region might be smaller than the available bytes if it wraps
+    ///       around, call this again after committing to get the rest.
+    ///
+    /// \warning Must only be called by the consumer thread
+    span<const std::byte> read_region() {
+        auto tail = m_tail.load(std::memory_order_relaxed);
+        auto offset = tail & m_mask;
+        auto size = std::min(available(tail, m_capacity - offset), m_capacity - offset);
+        return {static_cast<const std::byte*>(m_data + offset), size};
+    }
+
+    /// Release the bytes read from the region to the producer
+    ///
+    /// \warning Must only be called by the consumer thread
+    void commit_read(size_type count) {
+        auto tail = m_tail.load(std::memory_order_relaxed);
+        assert(count <= m_cached_head - tail);
+        m_tail.store(tail + count, std::memory_order_release);
+    }
+};
+
+} // namespace concurrency
+
+// bring symbols into parent namespace
+
+using concurrency::spsc_queue;
+
+} // namespace shard
@@ -0,0 +1,226 @@
+// Copyright (c) 2026 Miklos Molnar. All rights reserved.
+
+#pragma once
+
+#include "shard/concurrency/latch.hpp"
+#include "shard/concurrency/thread_pool.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace shard {
+namespace concurrency {
+
+/// Graph of tasks executed on a thread pool in dependency order
+///
+/// Every node counts its unfinished predecessors, a node is handed to the
+/// pool as soon as the last of them is done. The thread finishing a node
+/// continues with one of the successors it made ready, so chains of nodes do
+/// not go through the queues of the pool.
+///
+/// The graph is not modified by running it, so it can be built once and run
+/// any number of times.
+///
+/// \warning A graph must not be modified while it is running and it must not
+///          be run by multiple threads at once.
+class task_graph {
+    struct node_state;
+
+public:
+    using task_type = std::function<void()>;
+
+    /// Handle to a node of the graph
+    class node {
+        friend class task_graph;
+
+    public:
+        /// Make the given nodes wait for this one
+        template <typename... Nodes>
+        node& precede(Nodes... others) {
+            (link(m_state, others.m_state), ...);
+            return *this;
+        }
+
+        /// Make this node wait for the given ones
+        template <typename... Nodes>
+        node& succeed(Nodes... others) {
+            (link(others.m_state, m_state), ...);
+            return *this;
+        }
+
+    private:
+        explicit node(node_state* state) noexcept
+        : m_state(state) {}
+
+    private:
+        node_state* m_state;
+    };
+
+public:
+    task_graph() = default;
+
+    task_graph(const task_graph&) = delete;
+    task_graph& operator=(const task_graph&) = delete;
+
+    /// Add a new node executing the function
+    template <typename F>
+    node emplace(F&& fn) {
+        m_nodes.push_back(std::make_unique<node_state>(std::forward<F>(fn), m_nodes.size()));
+        return node(m_nodes.back().get());
+    }
+
+    /// Execute every node on the pool and block until they are done
+    ///
+    /// If a node throws, the nodes that have not started yet are skipped and
+    /// the first exception is rethrown once the running ones are done.
+    ///
+    /// \throw std::logic_error if the dependencies form a cycle, no node is
+    ///        executed then
+    ///
+    /// \warning The calling thread is blocked, so it must not be the only
+    ///          thread of the pool. The pool must not be stopped while the
+    ///          graph is running.
+    void run(thread_pool& pool) {
+        if (m_nodes.empty()) {
+            return;
+        }
+        // the nodes of a cycle would never be ready, blocking forever
+        if (!is_acyclic()) {
+            throw std::logic_error("shard::concurrency::task_graph::run()");
+        }
+
+        latch done(static_cast<std::ptrdiff_t>(m_nodes.size()));
+        m_pool = &pool;
+        m_done = &done;
+        m_failed.store(false, std::memory_order_relaxed);
+        m_exception = nullptr;
+
+        // reset the counters before releasing any node
+        for (auto& n : m_nodes) {
+            n->pending.store(n->dependencies, std::memory_order_relaxed);
+        }
+        for (auto& n : m_nodes) {
+            if (n->dependencies == 0) {
+                pool.run([this, state = n.get()] { execute(state); });
+            }
+        }
+
+        done.wait();
+        m_pool = nullptr;
+        m_done = nullptr;
+        if (m_exception) {
+            std::rethrow_exception(std::exchange(m_exception, nullptr));
+        }
+    }
+
+    /// Check if the dependencies form no cycles, so that every node can run
+    bool is_acyclic() const {
+        // Kahn's algorithm, every node is visited once all its predecessors
+        // have been
+        std::vector<std::size_t> pending;
+        std::vector<const node_state*> ready;
+        pending.reserve(m_nodes.size());
+        for (auto& n : m_nodes) {
+            pending.push_back(n->dependencies);
+            if (n->dependencies == 0) {
+                ready.push_back(n.get());
+            }
+        }
+        std::size_t visited = 0;
+        while (!ready.empty()) {
+            auto n = ready.back();
+            ready.pop_back();
+            ++visited;
+            for (auto s : n->successors) {
+                if (--pending[s->index] == 0) {
+                    ready.push_back(s);
+                }
+            }
+        }
+        return visited == m_nodes.size();
+    }
+
+    /// Remove every node
+    void clear() { m_nodes.clear(); }
+
+    /// Check if the graph has no nodes
+    bool is_empty() const noexcept { return m_nodes.empty(); }
+
+    /// Get the number of nodes
+    std::size_t size() const noexcept { return m_nodes.size(); }
+
+private:
+    struct node_state {
+        template <typename F>
+        node_state(F&& fn, std::size_t index)
+        : fn(std::forward<F>(fn))
+        , index(index) {}
+
+        task_type fn;
+        // the position of the node in the graph
+        std::size_t index;
+        std::vector<node_state*> successors;
+        std::size_t dependencies = 0;
+        std::atomic<std::size_t> pending = ATOMIC_VAR_INIT(0);
+    };
+
+private:
+    static void link(node_state* from, node_state* to) {
+        from->successors.push_back(to);
+        ++to->dependencies;
+    }
+
+    // execute the node and the chain of successors it makes ready
+    void execute(node_state* n) {
+        while (n) {
+            if (!m_failed.load(std::memory_order_relaxed)) {
+                try {
+                    n->fn();
+                } catch (...) {
+                    if (!m_failed.exchange(true, std::memory_order_relaxed)) {
+                        m_exception = std::current_exception();
+                    }
+                }
+            }
+
+            node_state* next = nullptr;
+            for (auto s : n->successors) {
+                if (s->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    if (!next) {
+                        next = s;
+                    } else {
+                        m_pool->run([this, s] { execute(s); });
+                    }
+                }
+            }
+
+            // the graph might be destroyed once the last node is done, it is
+            // only accessed again if there is a successor left to execute
+            m_done->count_down();
+            n = next;
+        }
+    }
+
+private:
+    std::vector<std::unique_ptr<node_state>> m_nodes;
+
+    // state of the current run
+    thread_pool* m_pool = nullptr;
+    latch* m_done = nullptr;
+    std::atomic<bool> m_failed = ATOMIC_VAR_INIT(false);
+    std::exception_ptr m_exception;
+};
+
+} // namespace concurrency
+
+// bring symbols into parent namespace
+
+using concurrency::task_graph;
+
+} // namespace shard
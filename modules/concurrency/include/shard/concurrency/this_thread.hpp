@@ -2,16 +2,133 @@
 
 #pragma once
 
+#include <bitset>
+#include <cstddef>
+#include <optional>
+
 namespace shard {
-namespace concurrency::this_thread {
+namespace concurrency {
+
+/// Set of logical CPUs a thread is allowed to run on
+class cpu_set {
+public:
+    /// The maximum number of CPUs in the set
+    static constexpr std::size_t max_size = 1024;
+
+public:
+    /// Create an empty set
+    cpu_set() = default;
+
+    /// Add the CPU to the set, CPUs not less than 'max_size' are ignored
+    void add(std::size_t cpu) noexcept {
+        if (cpu < max_size) {
+            m_cpus.set(cpu);
+        }
+    }
+
+    /// Remove the CPU from the set
+    void remove(std::size_t cpu) noexcept {
+        if (cpu < max_size) {
+            m_cpus.reset(cpu);
+        }
+    }
+
+    /// Check if the CPU is in the set
+    bool contains(std::size_t cpu) const { return cpu < max_size && m_cpus.test(cpu); }
+
+    /// Remove every CPU from the set
+    void clear() noexcept { m_cpus.reset(); }
+
+    /// Get the number of CPUs in the set
+    std::size_t count() const noexcept { return m_cpus.count(); }
+
+    /// Check if the set is empty
+    bool is_empty() const noexcept { return m_cpus.none(); }
+
+    /// Get the CPU with the given position among the CPUs in the set
+    ///
+    /// \warning The position must be less than 'count()'
+    std::size_t nth(std::size_t position) const {
+        for (std::size_t cpu = 0; cpu < max_size; ++cpu) {
+            if (m_cpus.test(cpu) && position-- == 0) {
+                return cpu;
+            }
+        }
+        return max_size;
+    }
+
+    bool operator==(const cpu_set& other) const noexcept { return m_cpus == other.m_cpus; }
+    bool operator!=(const cpu_set& other) const noexcept { return m_cpus != other.m_cpus; }
+
+private:
+    std::bitset<max_size> m_cpus;
+};
+
+/// Scheduling policy of a thread
+enum class scheduling_policy_t {
+    /// The default time-sharing policy
+    normal,
+    /// Time-sharing for CPU-intensive, non-interactive work
+    batch,
+    /// Only run when the system is otherwise idle
+    idle,
+    /// Real-time, first in first out
+    fifo,
+    /// Real-time, round-robin
+    round_robin,
+};
+
+namespace this_thread {
 
 /// Set the name of the current thread
 void set_name(const char* name);
 
-} // namespace concurrency::this_thread
+/// Restrict the current thread to the given CPUs
+///
+/// \note Not supported on Apple platforms, where the scheduler only takes
+///       affinity hints.
+///
+/// \return true if the affinity was changed, false otherwise
+bool set_affinity(const cpu_set& cpus);
+
+/// Get the CPUs the current thread is allowed to run on
+cpu_set affinity();
+
+/// Get the CPU the current thread is running on
+///
+/// \note The thread might be moved to another CPU right after the call unless
+///       its affinity only allows a single one.
+///
+/// \return The index of the CPU or nullopt if it cannot be determined
+std::optional<std::size_t> current_cpu();
+
+/// Get the NUMA node the current thread is running on
+///
+/// \return The index of the node or nullopt if it cannot be determined
+std::optional<std::size_t> numa_node();
+
+/// Set the scheduling policy and priority of the current thread
+///
+/// \note The priority is only used by the real-time policies, and changing to
+///       those usually requires elevated privileges.
+///
+/// \return true if the scheduling was changed, false otherwise
+bool set_scheduling(scheduling_policy_t policy, int priority = 0);
+
+/// Get the scheduling policy of the current thread
+scheduling_policy_t scheduling_policy();
+
+/// Get the scheduling priority of the current thread
+int priority();
+
+} // namespace this_thread
+} // namespace concurrency
 
 // bring symbols into parent namespace
 
+using concurrency::cpu_set;
+using concurrency::scheduling_policy_t;
+
 namespace this_thread = concurrency::this_thread;
 
 } // namespace shard
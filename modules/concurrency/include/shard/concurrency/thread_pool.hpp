@@ -2,18 +2,139 @@
 
 #pragma once
 
-#include "shard/concurrency/channel.hpp"
+#include "shard/concurrency/cache_line.hpp"
+#include "shard/concurrency/detail/coroutine_support.hpp"
+#include "shard/concurrency/detail/priority_task_queue.hpp"
+#include "shard/concurrency/detail/task.hpp"
+#include "shard/concurrency/detail/timer_wheel.hpp"
+#include "shard/concurrency/detail/work_stealing_deque.hpp"
+#include "shard/concurrency/future.hpp"
+#include "shard/concurrency/latency_histogram.hpp"
+#include "shard/concurrency/this_thread.hpp"
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <stdexcept>
+#include <string>
 #include <thread>
+#include <type_traits>
 #include <vector>
 
 namespace shard {
 namespace concurrency {
 
-class thread_pool {
+/// The way tasks are distributed between the threads of a pool
+enum class scheduling_t {
+    /// Every task goes through a single queue shared by all the threads
+    shared_queue,
+    /// Every thread has its own deque and idle threads steal from the others
+    work_stealing,
+};
+
+/// The way the threads of a pool are pinned to CPUs
+///
+/// \note 'compact' and 'scatter' follow the logical CPU numbering of the
+///       system, they do not know about SMT siblings or NUMA nodes. Use
+///       'cpu_list' to place the threads on a given topology.
+enum class placement_t {
+    /// The threads are not pinned
+    none,
+    /// Consecutive threads are pinned to neighbouring CPUs to share caches
+    compact,
+    /// The threads are spread evenly over the available CPUs
+    scatter,
+    /// The threads are pinned to the listed CPUs in order
+    cpu_list,
+};
+
+/// The priority of a task in a pool
+enum class priority_t {
+    /// Latency-critical tasks, executed before any other
+    high,
+    /// The default priority
+    normal,
+    /// Tasks executed when there is nothing more important to do
+    background,
+};
+
+/// Options for creating a thread pool
+struct thread_pool_options {
+    /// The number of threads, 0 means the maximum number of physical threads
+    unsigned int thread_count = 0;
+    /// The way tasks are distributed between the threads
+    scheduling_t scheduling = scheduling_t::shared_queue;
+    /// The way the threads are pinned to CPUs
+    placement_t placement = placement_t::none;
+    /// The CPUs used by the 'cpu_list' placement, must not be empty and each
+    /// must be less than 'cpu_set::max_size'
+    std::vector<std::size_t> cpus;
+    /// The name of the threads, followed by their index
+    std::string name;
+    /// The time after which a waiting task is promoted to the next priority
+    std::chrono::milliseconds aging = std::chrono::milliseconds(100);
+    /// The resolution of the timers of 'run_at' and 'run_after'
+    std::chrono::milliseconds timer_resolution = std::chrono::milliseconds(1);
+    /// Measure the time spent in and between the tasks and the time they wait
+    /// in the queues
+    ///
+    /// \note This reads the clock when a task is queued, started and finished,
+    ///       which is significant for short tasks. The task, steal and wait
+    ///       counters are always collected.
+    bool collect_metrics = false;
+};
+
+/// Counters of a thread of a pool
+struct worker_metrics {
+    /// The number of tasks executed
+    std::uint64_t tasks_executed = 0;
+    /// The number of tasks stolen from other threads
+    std::uint64_t steals = 0;
+    /// The number of times the thread blocked waiting for a task
+    std::uint64_t waits = 0;
+    /// The time spent executing tasks
+    std::chrono::nanoseconds busy_time {0};
+    /// The time spent between tasks
+    std::chrono::nanoseconds idle_time {0};
+};
+
+/// Snapshot of the counters of a pool
+struct thread_pool_metrics {
+    /// The counters of every thread
+    std::vector<worker_metrics> workers;
+    /// The time the tasks spent in the queues before being started
+    latency_histogram queue_latency;
+    /// The number of tasks waiting to be executed
+    std::size_t queued_tasks = 0;
+
+    /// Get the number of tasks executed by all the threads
+    std::uint64_t tasks_executed() const noexcept {
+        std::uint64_t result = 0;
+        for (auto& w : workers) {
+            result += w.tasks_executed;
+        }
+        return result;
+    }
+
+    /// Get the fraction of time the threads spent executing tasks
+    double utilization() const noexcept {
+        std::chrono::nanoseconds busy {0};
+        std::chrono::nanoseconds total {0};
+        for (auto& w : workers) {
+            busy += w.busy_time;
+            total += w.busy_time + w.idle_time;
+        }
+        return total.count() == 0 ? 0.0 : static_cast<double>(busy.count()) / static_cast<double>(total.count());
+    }
+};
+
+class thread_pool : private detail::executor {
 public:
     using task_type = std::function<void()>;
 
@@ -22,12 +143,51 @@ public:
     thread_pool()
     : thread_pool(max_thread_count()) {}
 
+    /// Create a thread pool with the maximum number of physical threads using
+    /// the given scheduling
+    explicit thread_pool(scheduling_t scheduling)
+    : thread_pool(max_thread_count(), scheduling) {}
+
     /// Create a thread pool with the given number of threads
-    explicit thread_pool(unsigned int count) {
+    ///
+    /// \note With work-stealing scheduling, tasks added from a worker thread
+    ///       are put on that thread's own deque, while tasks added from any
+    ///       other thread go through a shared injection queue.
+    explicit thread_pool(unsigned int count, scheduling_t scheduling = scheduling_t::shared_queue)
+    : thread_pool(options_for(count, scheduling)) {}
+
+    /// Create a thread pool with the given options
+    ///
+    /// \note The CPUs available for placement are the ones the calling thread
+    ///       is allowed to run on. Pinning is done on a best effort basis, it
+    ///       is silently skipped where it is not supported.
+    ///
+    /// \throw std::invalid_argument if the 'cpu_list' placement has no CPUs
+    /// \throw std::out_of_range if a CPU of the 'cpu_list' placement is not
+    ///        less than 'cpu_set::max_size'
+    explicit thread_pool(const thread_pool_options& options)
+    : m_scheduling(options.scheduling)
+    , m_collect_metrics(options.collect_metrics)
+    , m_name(options.name)
+    , m_tasks(options.aging)
+    , m_injection(options.aging)
+    , m_timers(options.timer_resolution) {
+        auto count = options.thread_count != 0 ? options.thread_count : max_thread_count();
+        m_cpus = place(options, count);
         try {
+            m_counters.reserve(count);
+            for (auto i = 0u; i < count; ++i) {
+                m_counters.push_back(std::make_unique<thread_counters>());
+            }
+            if (m_scheduling == scheduling_t::work_stealing) {
+                m_workers.reserve(count);
+                for (auto i = 0u; i < count; ++i) {
+                    m_workers.push_back(std::make_unique<worker>(this, i));
+                }
+            }
             m_threads.reserve(count);
             for (auto i = 0u; i < count; ++i) {
-                m_threads.emplace_back(&thread_pool::worker_thread, this);
+                m_threads.emplace_back(&thread_pool::worker_thread, this, i);
             }
         } catch (...) {
             destroy();
@@ -37,58 +197,651 @@ public:
 
     ~thread_pool() { destroy(); }
 
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
     /// Add a new task by copying it
-    void run(const task_type& task) { m_tasks.push(task); }
+    void run(const task_type& task) { schedule(detail::make_task(task)); }
 
     /// Add a new task by moving it
-    void run(task_type&& task) { m_tasks.push(std::move(task)); }
+    void run(task_type&& task) { schedule(detail::make_task(std::move(task))); }
 
     /// Add a new task by binding the given args
     template <typename F, typename... Args>
     void run(F&& f, Args&&... args) {
-        m_tasks.push(std::bind(std::forward<F>(f), std::forward<Args>(args)...));
+        schedule(bind_task(std::forward<F>(f), std::forward<Args>(args)...));
+    }
+
+    /// Add a new task with the given priority by binding the given args
+    ///
+    /// \note Tasks of lower priorities are promoted after waiting for the
+    ///       aging interval, so they are not starved.
+    template <typename F, typename... Args>
+    void run(priority_t priority, F&& f, Args&&... args) {
+        schedule(bind_task(std::forward<F>(f), std::forward<Args>(args)...), priority);
+    }
+
+    /// Add a new task by binding the given args, executed at the given time
+    ///
+    /// \note The task is added to the pool when the time is reached, so it
+    ///       might start later by up to the timer resolution. Timers that have
+    ///       not expired when the pool is stopped are discarded.
+    template <typename Clock, typename Duration, typename F, typename... Args>
+    void run_at(const std::chrono::time_point<Clock, Duration>& time, F&& f, Args&&... args) {
+        add_timer(to_steady(time), bind_task(std::forward<F>(f), std::forward<Args>(args)...));
+    }
+
+    /// Add a new task by binding the given args, executed after the delay
+    ///
+    /// \see run_at
+    template <typename Rep, typename Period, typename F, typename... Args>
+    void run_after(const std::chrono::duration<Rep, Period>& delay, F&& f, Args&&... args) {
+        run_at(std::chrono::steady_clock::now() + delay, std::forward<F>(f), std::forward<Args>(args)...);
+    }
+
+    /// Add a new task whose result can be retrieved through the future
+    ///
+    /// The arguments are stored alongside the function and the result in a
+    /// single allocation.
+    ///
+    /// \return A future holding the result of the function
+    template <typename F, typename... Args>
+    [[nodiscard]] auto submit(F&& f, Args&&... args) {
+        return submit(priority_t::normal, std::forward<F>(f), std::forward<Args>(args)...);
+    }
+
+    /// Add a new task with the given priority whose result can be retrieved
+    /// through the future
+    ///
+    /// \return A future holding the result of the function
+    template <typename F, typename... Args>
+    [[nodiscard]] auto submit(priority_t priority, F&& f, Args&&... args) {
+        using result_type = std::invoke_result_t<std::decay_t<F>, std::decay_t<Args>...>;
+        using task_type = detail::packaged_task<result_type, std::decay_t<F>, std::decay_t<Args>...>;
+        auto task = new task_type(this, std::forward<F>(f), std::forward<Args>(args)...);
+        future<result_type> result(task);
+        schedule(detail::task_ptr(task), priority);
+        return result;
+    }
+
+#if SHARD_HAS_COROUTINES
+    /// Get an awaitable resuming the awaiting coroutine on one of the threads
+    ///
+    /// \warning If the pool is stopped before the coroutine is resumed, it is
+    ///          never resumed.
+    [[nodiscard]] auto schedule(priority_t priority = priority_t::normal) noexcept {
+        struct awaiter {
+            bool await_ready() const noexcept { return false; }
+
+            void await_suspend(std::coroutine_handle<> handle) {
+                pool->schedule(detail::make_task([handle] { handle.resume(); }), priority);
+            }
+
+            void await_resume() const noexcept {}
+
+            thread_pool* pool;
+            priority_t priority;
+        };
+        return awaiter {this, priority};
+    }
+#endif
+
+    /// Stop every thread
+    ///
+    /// \note Tasks that have not been started yet are not executed.
+    void stop() {
+        {
+            std::lock_guard lock(m_timer_mutex);
+            m_timer_stopping = true;
+        }
+        m_timer_cv.notify_all();
+
+        if (m_scheduling == scheduling_t::shared_queue) {
+            {
+                std::lock_guard lock(m_tasks_mutex);
+                m_is_open = false;
+            }
+            m_tasks_cv.notify_all();
+            return;
+        }
+        m_stopping.store(true, std::memory_order_release);
+        {
+            // synchronize with the threads checking the flag before parking
+            std::lock_guard lock(m_park_mutex);
+        }
+        m_park_cv.notify_all();
     }
 
-    /// Stop every thread by closing the channel
-    void stop() { m_tasks.close(); }
+    /// Get the scheduling used by the pool
+    scheduling_t scheduling() const { return m_scheduling; }
 
     /// Get the number of threads in the pool
     std::size_t thread_count() const { return m_threads.size(); }
 
     /// Get the number of tasks waiting to be executed
-    std::size_t task_count() const { return m_tasks.size(); }
+    ///
+    /// \note This is only an approximation, it is computed without locking.
+    std::size_t task_count() const {
+        if (m_scheduling == scheduling_t::shared_queue) {
+            return m_tasks_size.load(std::memory_order_relaxed);
+        }
+        auto count = m_injection_size.load(std::memory_order_relaxed);
+        for (auto& w : m_workers) {
+            count += w->deque.size();
+        }
+        return count;
+    }
+
+    /// Get a snapshot of the counters of the pool and its threads
+    ///
+    /// \note The counters are read without locking, so they are not
+    ///       necessarily consistent with each other. The times and the queue
+    ///       latency are only measured if enabled in the options.
+    thread_pool_metrics metrics() const {
+        thread_pool_metrics result;
+        result.queued_tasks = task_count();
+        result.workers.reserve(m_counters.size());
+        auto now = clock::now().time_since_epoch();
+        for (auto& c : m_counters) {
+            worker_metrics w;
+            w.tasks_executed = c->tasks_executed.load(std::memory_order_relaxed);
+            w.steals = c->steals.load(std::memory_order_relaxed);
+            w.waits = c->waits.load(std::memory_order_relaxed);
+            w.busy_time = std::chrono::nanoseconds(c->busy_time.load(std::memory_order_relaxed));
+            w.idle_time = std::chrono::nanoseconds(c->idle_time.load(std::memory_order_relaxed));
+            if (m_collect_metrics) {
+                // account for the time since the thread last changed state
+                auto since = std::chrono::nanoseconds(c->since.load(std::memory_order_relaxed));
+                auto elapsed = std::max(now - since, clock::duration::zero());
+                (c->is_busy.load(std::memory_order_relaxed) ? w.busy_time : w.idle_time) += elapsed;
+            }
+            c->queue_latency.merge_into(result.queue_latency);
+            result.workers.push_back(w);
+        }
+        return result;
+    }
 
 public:
     /// Get the maximum number of physical threads
     static unsigned max_thread_count() noexcept { return std::max(std::thread::hardware_concurrency(), 2u) - 1u; }
 
 private:
+    // per-thread state used by the work-stealing scheduling
+    struct alignas(cache_line_size) worker {
+        worker(thread_pool* pool, unsigned int index)
+        : pool(pool)
+        , seed(index + 1) {}
+
+        thread_pool* pool;
+        std::uint32_t seed;
+        // the number of tasks looked for, to check the injection queue
+        // periodically
+        std::uint32_t ticks = 0;
+        detail::work_stealing_deque<detail::task_base*> deque;
+    };
+
+    using clock = std::chrono::steady_clock;
+
+    // counters of a thread, only written by the thread itself
+    struct alignas(cache_line_size) thread_counters {
+        std::atomic<std::uint64_t> tasks_executed = ATOMIC_VAR_INIT(0);
+        std::atomic<std::uint64_t> steals = ATOMIC_VAR_INIT(0);
+        std::atomic<std::uint64_t> waits = ATOMIC_VAR_INIT(0);
+        std::atomic<std::int64_t> busy_time = ATOMIC_VAR_INIT(0);
+        std::atomic<std::int64_t> idle_time = ATOMIC_VAR_INIT(0);
+        // the time the thread last started or finished a task
+        std::atomic<std::int64_t> since = ATOMIC_VAR_INIT(0);
+        std::atomic<bool> is_busy = ATOMIC_VAR_INIT(false);
+        detail::atomic_latency_histogram queue_latency;
+    };
+
+    // the number of times an idle thread looks for work before parking
+    static constexpr int spin_count = 64;
+
+    // the maximum number of tasks moved from the injection queue at once
+    static constexpr std::size_t max_injection_batch = 32;
+
+    // the number of tasks a thread looks for between checking the injection
+    // queue for aged tasks before its local work
+    static constexpr std::uint32_t injection_poll_interval = 32;
+
+    static constexpr std::size_t priority_count = 3;
+
+private:
+    // schedule the continuations of the futures
+    void execute(detail::task_ptr task) override { schedule(std::move(task)); }
+
+    // create a task calling the function with the given args
+    template <typename F, typename... Args>
+    static detail::task_ptr bind_task(F&& f, Args&&... args) {
+        if constexpr (sizeof...(Args) == 0) {
+            return detail::make_task(std::forward<F>(f));
+        } else {
+            return detail::make_task(std::bind(std::forward<F>(f), std::forward<Args>(args)...));
+        }
+    }
+
+    // convert the time point to the clock of the timers
+    template <typename Clock, typename Duration>
+    static std::chrono::steady_clock::time_point to_steady(const std::chrono::time_point<Clock, Duration>& time) {
+        using steady_duration = std::chrono::steady_clock::duration;
+        if constexpr (std::is_same_v<Clock, std::chrono::steady_clock>) {
+            return std::chrono::ceil<steady_duration>(time);
+        } else {
+            return std::chrono::steady_clock::now() + std::chrono::ceil<steady_duration>(time - Clock::now());
+        }
+    }
+
+    static thread_pool_options options_for(unsigned int count, scheduling_t scheduling) {
+        thread_pool_options options;
+        options.thread_count = count;
+        options.scheduling = scheduling;
+        return options;
+    }
+
+    // assign a CPU to every thread according to the placement
+    static std::vector<std::size_t> place(const thread_pool_options& options, unsigned int count) {
+        std::vector<std::size_t> result;
+        if (options.placement == placement_t::none) {
+            return result;
+        }
+        if (options.placement == placement_t::cpu_list) {
+            // checked here, as the threads could not report it
+            if (options.cpus.empty()) {
+                throw std::invalid_argument("shard::concurrency::thread_pool::thread_pool()");
+            }
+            for (auto cpu : options.cpus) {
+                if (cpu >= cpu_set::max_size) {
+                    throw std::out_of_range("shard::concurrency::thread_pool::thread_pool()");
+                }
+            }
+            for (auto i = 0u; i < count; ++i) {
+                result.push_back(options.cpus[i % options.cpus.size()]);
+            }
+            return result;
+        }
+        auto available = this_thread::affinity();
+        auto size = available.count();
+        for (auto i = 0u; i < count && size != 0; ++i) {
+            auto position = options.placement == placement_t::compact ? i % size : (i * size / count) % size;
+            result.push_back(available.nth(position));
+        }
+        return result;
+    }
+
+    // add to a counter only written by the calling thread
+    template <typename T>
+    static void increment(std::atomic<T>& counter, T value = 1) noexcept {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    // execute the task and update the counters of the calling thread
+    void run_task(detail::task_ptr task, thread_counters& counters) {
+        if (!m_collect_metrics) {
+            task->run();
+            increment<std::uint64_t>(counters.tasks_executed);
+            return;
+        }
+
+        auto start = clock::now();
+        auto since = clock::duration(counters.since.load(std::memory_order_relaxed));
+        counters.queue_latency.record(start - task->queued_at);
+        increment<std::int64_t>(counters.idle_time, (start.time_since_epoch() - since).count());
+        counters.since.store(start.time_since_epoch().count(), std::memory_order_relaxed);
+        counters.is_busy.store(true, std::memory_order_relaxed);
+
+        task->run();
+
+        auto end = clock::now();
+        increment<std::int64_t>(counters.busy_time, (end - start).count());
+        increment<std::uint64_t>(counters.tasks_executed);
+        counters.since.store(end.time_since_epoch().count(), std::memory_order_relaxed);
+        counters.is_busy.store(false, std::memory_order_relaxed);
+    }
+
     // thread function polling and executing the tasks
-    void worker_thread() {
-        while (auto task = m_tasks.pop()) {
-            (*task)();
+    void worker_thread(unsigned int index) {
+        if (!m_cpus.empty()) {
+            cpu_set cpus;
+            cpus.add(m_cpus[index]);
+            this_thread::set_affinity(cpus);
+        }
+        if (!m_name.empty()) {
+            this_thread::set_name((m_name + '-' + std::to_string(index)).c_str());
+        }
+
+        auto& counters = *m_counters[index];
+        counters.since.store(clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+
+        if (m_scheduling == scheduling_t::shared_queue) {
+            while (auto task = pop_task(counters)) {
+                run_task(std::move(task), counters);
+            }
+        } else {
+            work_stealing_thread(*m_workers[index], counters);
+        }
+    }
+
+    // thread function of the work-stealing scheduling
+    void work_stealing_thread(worker& self, thread_counters& counters) {
+        t_worker = &self;
+        while (!m_stopping.load(std::memory_order_acquire)) {
+            if (auto task = find_task(self, counters)) {
+                run_task(std::move(task), counters);
+            } else {
+                park(counters);
+            }
+        }
+        t_worker = nullptr;
+    }
+
+    // wait for the next task of the shared queue
+    detail::task_ptr pop_task(thread_counters& counters) {
+        std::unique_lock lock(m_tasks_mutex);
+        if (m_is_open && m_tasks.is_empty()) {
+            increment<std::uint64_t>(counters.waits);
+            // unblock if stopped or there's something new on the queue
+            m_tasks_cv.wait(lock, [this] { return !m_is_open || !m_tasks.is_empty(); });
+        }
+        if (!m_is_open) {
+            return nullptr;
+        }
+        auto task = m_tasks.pop();
+        m_tasks_size.store(m_tasks.size(), std::memory_order_relaxed);
+        return task;
+    }
+
+    // add the task to the appropriate queue
+    void schedule(detail::task_ptr task, priority_t priority = priority_t::normal) {
+        if (m_collect_metrics) {
+            task->queued_at = clock::now();
+        }
+
+        auto level = static_cast<std::size_t>(priority);
+        if (m_scheduling == scheduling_t::shared_queue) {
+            {
+                std::lock_guard lock(m_tasks_mutex);
+                if (!m_is_open) {
+                    return;
+                }
+                m_tasks.push(std::move(task), level);
+                m_tasks_size.store(m_tasks.size(), std::memory_order_relaxed);
+            }
+            m_tasks_cv.notify_one();
+            return;
+        }
+
+        if (m_stopping.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        if (auto self = t_worker; self && self->pool == this && priority == priority_t::normal) {
+            // keep the work local to the thread that created it
+            self->deque.push(task.release());
+        } else {
+            // the local deques have no priorities, so every other task goes
+            // through the injection queue
+            std::lock_guard lock(m_injection_mutex);
+            m_injection.push(std::move(task), level);
+            update_injection_size();
+        }
+
+        wake_one();
+    }
+
+    // add the task to the timers, starting the timer thread on first use
+    void add_timer(std::chrono::steady_clock::time_point time, detail::task_ptr task) {
+        {
+            std::lock_guard lock(m_timer_mutex);
+            if (m_timer_stopping) {
+                return;
+            }
+            if (!m_timer_thread.joinable()) {
+                m_timer_thread = std::thread(&thread_pool::timer_thread, this);
+            }
+            m_timers.add(time, std::move(task));
         }
+        m_timer_cv.notify_one();
     }
 
-    // clear the channel and join the threads
+    // thread function moving the expired timers to the pool
+    void timer_thread() {
+        if (!m_name.empty()) {
+            this_thread::set_name((m_name + "-timer").c_str());
+        }
+
+        std::vector<detail::task_ptr> expired;
+        std::unique_lock lock(m_timer_mutex);
+        while (!m_timer_stopping) {
+            if (auto next = m_timers.next_expiry()) {
+                m_timer_cv.wait_until(lock, *next);
+            } else {
+                m_timer_cv.wait(lock);
+            }
+            m_timers.advance(std::chrono::steady_clock::now(),
+                             [&expired](detail::task_ptr task) { expired.push_back(std::move(task)); });
+            if (expired.empty()) {
+                continue;
+            }
+            lock.unlock();
+            for (auto& task : expired) {
+                schedule(std::move(task));
+            }
+            expired.clear();
+            lock.lock();
+        }
+    }
+
+    // look for a task in the local deque, the injection queue or steal one
+    detail::task_ptr find_task(worker& self, thread_counters& counters) {
+        // latency-critical tasks go before the local work
+        if (m_injection_high.load(std::memory_order_relaxed) != 0) {
+            if (auto task = pop_injection(self)) {
+                return task;
+            }
+        }
+        // so do the ones promoted to normal by aging, otherwise a thread busy
+        // with its own work would starve them
+        if (++self.ticks % injection_poll_interval == 0) {
+            if (auto task = pop_injection(self, static_cast<std::size_t>(priority_t::normal))) {
+                return task;
+            }
+        }
+        if (auto task = self.deque.pop()) {
+            return detail::task_ptr(task);
+        }
+        if (auto task = pop_injection(self)) {
+            return task;
+        }
+        auto task = steal(self);
+        if (task) {
+            increment<std::uint64_t>(counters.steals);
+        }
+        return task;
+    }
+
+    // take a task from the injection queue if its level after aging is at
+    // most 'max_level', moving a fair share of the rest to the local deque to
+    // reduce contention on the injection queue
+    detail::task_ptr pop_injection(worker& self, std::size_t max_level = priority_count) {
+        if (m_injection_size.load(std::memory_order_relaxed) == 0) {
+            return nullptr;
+        }
+
+        std::lock_guard lock(m_injection_mutex);
+        if (m_injection.top_level() > max_level) {
+            return nullptr;
+        }
+        auto result = m_injection.pop();
+        if (!result) {
+            return nullptr;
+        }
+
+        // only normal tasks are moved, the others would lose their priority
+        auto normal = static_cast<std::size_t>(priority_t::normal);
+        auto share = std::min(m_injection.size(normal) / m_workers.size(), max_injection_batch);
+        for (std::size_t i = 0; i < share; ++i) {
+            self.deque.push(m_injection.pop(normal).release());
+        }
+
+        update_injection_size();
+        return result;
+    }
+
+    // publish the size of the injection queue, must be called with the lock
+    // held
+    void update_injection_size() {
+        m_injection_size.store(m_injection.size(), std::memory_order_relaxed);
+        m_injection_high.store(m_injection.size(static_cast<std::size_t>(priority_t::high)),
+                               std::memory_order_relaxed);
+    }
+
+    // try to steal a task from the other threads starting at a random victim
+    detail::task_ptr steal(worker& self) {
+        // xorshift32
+        self.seed ^= self.seed << 13;
+        self.seed ^= self.seed >> 17;
+        self.seed ^= self.seed << 5;
+
+        auto count = m_workers.size();
+        auto start = self.seed % count;
+        for (std::size_t i = 0; i < count; ++i) {
+            auto& victim = *m_workers[(start + i) % count];
+            if (&victim == &self) {
+                continue;
+            }
+            if (auto task = victim.deque.steal()) {
+                return detail::task_ptr(task);
+            }
+        }
+        return nullptr;
+    }
+
+    // check if there is any work available for an idle thread
+    bool has_work() const {
+        if (m_injection_size.load(std::memory_order_relaxed) != 0) {
+            return true;
+        }
+        return std::any_of(m_workers.begin(), m_workers.end(), [](auto& w) { return !w->deque.is_empty(); });
+    }
+
+    // block the calling worker thread until there is new work
+    void park(thread_counters& counters) {
+        for (auto i = 0; i < spin_count; ++i) {
+            if (has_work() || m_stopping.load(std::memory_order_relaxed)) {
+                return;
+            }
+            std::this_thread::yield();
+        }
+
+        // announce the intention to sleep before checking for work one last
+        // time, so that a concurrent 'schedule()' either sees the sleeper or
+        // its task is seen here
+        m_sleeping.fetch_add(1, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (!has_work()) {
+            increment<std::uint64_t>(counters.waits);
+            std::unique_lock lock(m_park_mutex);
+            m_park_cv.wait(lock, [this] { return m_wakeups > 0 || m_stopping.load(std::memory_order_relaxed); });
+            if (m_wakeups > 0) {
+                --m_wakeups;
+            }
+        }
+
+        m_sleeping.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    // wake a parked worker thread if there is any
+    void wake_one() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_sleeping.load(std::memory_order_relaxed) == 0) {
+            return;
+        }
+        {
+            std::lock_guard lock(m_park_mutex);
+            if (m_wakeups < m_sleeping.load(std::memory_order_relaxed)) {
+                ++m_wakeups;
+            }
+        }
+        m_park_cv.notify_one();
+    }
+
+    // stop and join the threads then destroy the remaining tasks
     void destroy() {
-        m_tasks.close();
+        stop();
         for (auto& thread : m_threads) {
             thread.join();
         }
         m_threads.clear();
+        if (m_timer_thread.joinable()) {
+            m_timer_thread.join();
+        }
+        m_timers.clear();
         m_tasks.clear();
+        for (auto& w : m_workers) {
+            while (auto task = w->deque.pop()) {
+                task->destroy();
+            }
+        }
+        m_workers.clear();
+        m_injection.clear();
     }
 
 private:
+    scheduling_t m_scheduling;
     std::vector<std::thread> m_threads;
-    channel<task_type> m_tasks;
+
+    // counters of the threads
+    bool m_collect_metrics;
+    std::vector<std::unique_ptr<thread_counters>> m_counters;
+
+    // placement and naming of the threads
+    std::string m_name;
+    std::vector<std::size_t> m_cpus;
+
+    // shared queue scheduling
+    detail::priority_task_queue<priority_count> m_tasks;
+    std::mutex m_tasks_mutex;
+    std::condition_variable m_tasks_cv;
+    std::atomic<std::size_t> m_tasks_size = ATOMIC_VAR_INIT(0);
+    bool m_is_open = true;
+
+    // work-stealing scheduling
+    std::vector<std::unique_ptr<worker>> m_workers;
+    detail::priority_task_queue<priority_count> m_injection;
+    std::mutex m_injection_mutex;
+    std::atomic<std::size_t> m_injection_size = ATOMIC_VAR_INIT(0);
+    std::atomic<std::size_t> m_injection_high = ATOMIC_VAR_INIT(0);
+    std::atomic<bool> m_stopping = ATOMIC_VAR_INIT(false);
+
+    // parking of idle worker threads
+    std::mutex m_park_mutex;
+    std::condition_variable m_park_cv;
+    std::atomic<unsigned int> m_sleeping = ATOMIC_VAR_INIT(0);
+    unsigned int m_wakeups = 0;
+
+    // timers of delayed tasks
+    detail::timer_wheel<detail::task_ptr> m_timers;
+    std::thread m_timer_thread;
+    std::mutex m_timer_mutex;
+    std::condition_variable m_timer_cv;
+    bool m_timer_stopping = false;
+
+    // the worker of the current thread if it belongs to a work-stealing pool
+    inline static thread_local worker* t_worker = nullptr;
 };
 
 } // namespace concurrency
 
 // bring symbols into parent namespace
 
+using concurrency::placement_t;
+using concurrency::priority_t;
+using concurrency::scheduling_t;
 using concurrency::thread_pool;
+using concurrency::thread_pool_metrics;
+using concurrency::thread_pool_options;
+using concurrency::worker_metrics;
 
 } // namespace shard
@@ -74,7 +74,7 @@ private:
     };
 
 public:
-    template <template <typename> class Lock = std::shared_lock>
+    template <template <typename> class Lock = read_lock>
     using read_access = access<Lock, access_mode::read_only>;
 
     template <template <typename> class Lock = std::lock_guard>
@@ -114,7 +114,7 @@ using thread_safe = basic_thread_safe<T, std::mutex>;
 template <typename T>
 using rw_thread_safe = basic_thread_safe<T, std::shared_mutex>;
 
-template <typename ThreadSafe, template <typename> class Lock = std::shared_lock>
+template <typename ThreadSafe, template <typename> class Lock = read_lock>
 using read_access = typename ThreadSafe::template read_access<Lock>;
 
 template <typename ThreadSafe, template <typename> class Lock = std::lock_guard>
@@ -124,6 +124,7 @@ using write_access = typename ThreadSafe::template write_access<Lock>;
 
 // bring symbols into parent namespace
 
+using concurrency::basic_thread_safe;
 using concurrency::read_access;
 using concurrency::rw_thread_safe;
 using concurrency::thread_safe;
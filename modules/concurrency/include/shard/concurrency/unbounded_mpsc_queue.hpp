@@ -0,0 +1,273 @@
+// Copyright (c) 2026 Miklos Molnar. All rights reserved.
+
+#pragma once
+
+#include "shard/concurrency/cache_line.hpp"
+#include "shard/concurrency/detail/backoff.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace shard {
+namespace concurrency {
+
+/// Unbounded multi-producer single-consumer queue
+///
+/// The items are stored in a linked list of fixed size segments. Producers
+/// claim slots in the last segment with a single atomic increment, the
+/// producer claiming the first slot past its end links the next segment.
+/// Segments emptied by the consumer are recycled through a free list, so
+/// memory is only allocated while the queue grows beyond its previous size.
+///
+/// Items are created before their slot is claimed unless that cannot throw,
+/// so a throwing constructor leaves the queue untouched.
+///
+/// \note Producers overflowing a segment wait for the next one to be linked,
+///       which only happens once every 'SegmentSize' items.
+template <typename T, std::size_t SegmentSize = 256>
+class unbounded_mpsc_queue {
+    static_assert(SegmentSize >= 2, "segments must hold at least 2 items");
+    static_assert(std::is_nothrow_move_constructible_v<T>, "moving the items must not throw");
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+
+public:
+    unbounded_mpsc_queue()
+    : m_head_segment(new segment) {
+        m_tail_segment.store(m_head_segment, std::memory_order_relaxed);
+    }
+
+    unbounded_mpsc_queue(const unbounded_mpsc_queue&) = delete;
+    unbounded_mpsc_queue& operator=(const unbounded_mpsc_queue&) = delete;
+
+    /// Destroy the items still in the queue and release every segment
+    ~unbounded_mpsc_queue() {
+        while (pop()) {}
+        while (m_head_segment) {
+            delete std::exchange(m_head_segment, m_head_segment->next.load(std::memory_order_relaxed));
+        }
+        while (m_retired) {
+            delete std::exchange(m_retired, m_retired->next_retired);
+        }
+        auto s = m_free.load(std::memory_order_relaxed);
+        while (s) {
+            delete std::exchange(s, s->next_free.load(std::memory_order_relaxed));
+        }
+    }
+
+    /// Add a new item to the queue by copying it
+    ///
+    /// \note It is safe to call this from multiple threads
+    void push(const value_type& value) { emplace(value); }
+
+    /// Add a new item to the queue by moving it
+    ///
+    /// \note It is safe to call this from multiple threads
+    void push(value_type&& value) { emplace(std::move(value)); }
+
+    /// Add a new item to the queue by creating it in-place
+    ///
+    /// \note It is safe to call this from multiple threads
+    template <typename... Args>
+    void emplace(Args&&... args) {
+        if constexpr (std::is_nothrow_constructible_v<value_type, Args&&...>) {
+            // the claimed slot must be published and the producer unregistered
+            auto [s, index] = claim();
+            new (s->storage(index)) value_type(std::forward<Args>(args)...);
+            s->states[index].store(true, std::memory_order_release);
+            s->users.fetch_sub(1, std::memory_order_release);
+            m_size.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            value_type value(std::forward<Args>(args)...);
+            emplace(std::move(value));
+        }
+    }
+
+    /// Pop and retrieve the next item from the queue
+    ///
+    /// \warning It is *NOT* safe to call this from multiple threads
+    std::optional<value_type> pop() {
+        if (!is_ready()) {
+            return std::nullopt;
+        }
+
+        auto item = m_head_segment->data(m_head_index);
+        std::optional<value_type> value(std::move(*item));
+        release(item);
+        return value;
+    }
+
+    /// Pop up to 'max' items from the queue
+    ///
+    /// \warning It is *NOT* safe to call this from multiple threads
+    ///
+    /// \return The number of items retrieved
+    template <typename OutputIt>
+    size_type drain(OutputIt out, size_type max) {
+        size_type count = 0;
+        for (; count < max && is_ready(); ++count) {
+            // the item is released before writing the output can throw
+            auto item = m_head_segment->data(m_head_index);
+            value_type value(std::move(*item));
+            release(item);
+            *out = std::move(value);
+            ++out;
+        }
+        return count;
+    }
+
+    /// Check if the queue is empty
+    ///
+    /// \note This is only an approximation while producers are pushing.
+    bool is_empty() const noexcept { return size() == 0; }
+
+    /// Get the number of items in the queue
+    ///
+    /// \note This is only an approximation while producers are pushing.
+    size_type size() const noexcept {
+        auto size = m_size.load(std::memory_order_relaxed);
+        return size > 0 ? static_cast<size_type>(size) : 0;
+    }
+
+    /// Get the number of items a segment holds
+    static constexpr size_type segment_size() noexcept { return SegmentSize; }
+
+private:
+    struct segment {
+        segment() {
+            for (auto& state : states) {
+                state.store(false, std::memory_order_relaxed);
+            }
+        }
+
+        void* storage(size_type index) noexcept { return &slots[index * sizeof(value_type)]; }
+
+        value_type* data(size_type index) noexcept { return std::launder(reinterpret_cast<value_type*>(storage(index))); }
+
+        // the number of slots claimed by producers, can exceed the size
+        alignas(cache_line_size) std::atomic<size_type> claimed = ATOMIC_VAR_INIT(0);
+        // the number of producers accessing the segment
+        std::atomic<size_type> users = ATOMIC_VAR_INIT(0);
+        std::atomic<segment*> next = ATOMIC_VAR_INIT(nullptr);
+        // link in the free list
+        std::atomic<segment*> next_free = ATOMIC_VAR_INIT(nullptr);
+        // link in the list of retired segments, only used by the consumer
+        segment* next_retired = nullptr;
+        std::atomic<bool> states[SegmentSize];
+        alignas(value_type) std::byte slots[sizeof(value_type) * SegmentSize];
+    };
+
+private:
+    // claim a slot in the last segment, returned with the producer registered
+    // as a user of the segment
+    std::pair<segment*, size_type> claim() {
+        detail::exponential_backoff backoff;
+        while (true) {
+            auto s = m_tail_segment.load(std::memory_order_seq_cst);
+            // the segment might be recycled until the producer is registered
+            // while it is still the last one
+            s->users.fetch_add(1, std::memory_order_seq_cst);
+            if (m_tail_segment.load(std::memory_order_seq_cst) != s) {
+                s->users.fetch_sub(1, std::memory_order_release);
+                continue;
+            }
+
+            auto index = s->claimed.fetch_add(1, std::memory_order_relaxed);
+            if (index < SegmentSize) {
+                return {s, index};
+            }
+            if (index == SegmentSize) {
+                // only one producer links the next segment, so the free list
+                // never has concurrent poppers
+                auto next = acquire_segment();
+                s->next.store(next, std::memory_order_release);
+                m_tail_segment.store(next, std::memory_order_seq_cst);
+                backoff.reset();
+            } else {
+                backoff.pause();
+            }
+            s->users.fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+    // take a segment from the free list or allocate a new one
+    segment* acquire_segment() {
+        auto s = m_free.load(std::memory_order_acquire);
+        while (s && !m_free.compare_exchange_weak(s,
+                                                  s->next_free.load(std::memory_order_relaxed),
+                                                  std::memory_order_acquire,
+                                                  std::memory_order_acquire)) {}
+        return s ? s : new segment;
+    }
+
+    // check if the next item is published, moving to the next segment once
+    // the current one is consumed
+    bool is_ready() {
+        if (m_head_index == SegmentSize) {
+            auto next = m_head_segment->next.load(std::memory_order_acquire);
+            if (!next) {
+                return false;
+            }
+            retire(std::exchange(m_head_segment, next));
+            m_head_index = 0;
+        }
+        return m_head_segment->states[m_head_index].load(std::memory_order_acquire);
+    }
+
+    // destroy the consumed item and advance to the next slot
+    void release(value_type* item) {
+        item->~value_type();
+        m_head_segment->states[m_head_index].store(false, std::memory_order_relaxed);
+        ++m_head_index;
+        m_size.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    // recycle the consumed segment once no producer is accessing it
+    void retire(segment* s) {
+        s->next_retired = m_retired;
+        m_retired = s;
+
+        auto link = &m_retired;
+        while (auto r = *link) {
+            // a producer registered before the last segment changed might
+            // still be about to claim a slot
+            if (m_tail_segment.load(std::memory_order_seq_cst) == r || r->users.load(std::memory_order_seq_cst) != 0) {
+                link = &r->next_retired;
+                continue;
+            }
+            *link = r->next_retired;
+            r->claimed.store(0, std::memory_order_relaxed);
+            r->next.store(nullptr, std::memory_order_relaxed);
+            auto head = m_free.load(std::memory_order_relaxed);
+            do {
+                r->next_free.store(head, std::memory_order_relaxed);
+            } while (!m_free.compare_exchange_weak(head, r, std::memory_order_release, std::memory_order_relaxed));
+        }
+    }
+
+private:
+    // producers
+    alignas(cache_line_size) std::atomic<segment*> m_tail_segment = ATOMIC_VAR_INIT(nullptr);
+    alignas(cache_line_size) std::atomic<segment*> m_free = ATOMIC_VAR_INIT(nullptr);
+    alignas(cache_line_size) std::atomic<std::ptrdiff_t> m_size = ATOMIC_VAR_INIT(0);
+
+    // consumer
+    alignas(cache_line_size) segment* m_head_segment;
+    size_type m_head_index = 0;
+    // consumed segments still accessed by producers
+    segment* m_retired = nullptr;
+};
+
+} // namespace concurrency
+
+// bring symbols into parent namespace
+
+using concurrency::unbounded_mpsc_queue;
+
+} // namespace shard
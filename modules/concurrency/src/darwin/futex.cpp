@@ -0,0 +1,66 @@
+// Copyright (c) 2026 Miklos Molnar. All rights reserved.
+
+#include "shard/concurrency/futex.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+// there is no public futex API on Apple platforms, so the waiters block on
+// condition variables selected by hashing the address of the word
+
+namespace shard::concurrency {
+
+namespace {
+
+struct bucket {
+    std::mutex mutex;
+    std::condition_variable cv;
+};
+
+constexpr std::size_t bucket_count = 64;
+
+bucket& bucket_of(const std::atomic<std::uint32_t>& word) {
+    static bucket buckets[bucket_count];
+    auto address = reinterpret_cast<std::uintptr_t>(&word);
+    return buckets[(address >> 4) % bucket_count];
+}
+
+} // namespace
+
+void futex_wait(const std::atomic<std::uint32_t>& word, std::uint32_t expected) {
+    auto& b = bucket_of(word);
+    std::unique_lock lock(b.mutex);
+    if (word.load(std::memory_order_acquire) == expected) {
+        b.cv.wait(lock);
+    }
+}
+
+bool futex_wait_for(const std::atomic<std::uint32_t>& word, std::uint32_t expected, std::chrono::nanoseconds timeout) {
+    if (timeout <= std::chrono::nanoseconds::zero()) {
+        return false;
+    }
+    auto& b = bucket_of(word);
+    std::unique_lock lock(b.mutex);
+    if (word.load(std::memory_order_acquire) != expected) {
+        return true;
+    }
+    return b.cv.wait_for(lock, timeout) == std::cv_status::no_timeout;
+}
+
+void futex_wake_one(const std::atomic<std::uint32_t>& word) {
+    // other words might share the bucket, so every waiter has to be woken
+    futex_wake_all(word);
+}
+
+void futex_wake_all(const std::atomic<std::uint32_t>& word) {
+    auto& b = bucket_of(word);
+    {
+        // synchronize with the threads about to wait
+        std::lock_guard lock(b.mutex);
+    }
+    b.cv.notify_all();
+}
+
+} // namespace shard::concurrency
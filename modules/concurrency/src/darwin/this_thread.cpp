@@ -5,6 +5,8 @@
 #include <cstring>
 
 #include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
 
 namespace shard::concurrency::this_thread {
 
@@ -19,4 +21,57 @@ void set_name(const char* name) {
     }
 }
 
+bool set_affinity(const cpu_set& /* cpus */) {
+    // threads cannot be pinned to CPUs on Apple platforms
+    return false;
+}
+
+cpu_set affinity() {
+    cpu_set result;
+    auto count = sysconf(_SC_NPROCESSORS_ONLN);
+    for (long cpu = 0; cpu < count && static_cast<std::size_t>(cpu) < cpu_set::max_size; ++cpu) {
+        result.add(static_cast<std::size_t>(cpu));
+    }
+    return result;
+}
+
+std::optional<std::size_t> current_cpu() {
+    return std::nullopt;
+}
+
+std::optional<std::size_t> numa_node() {
+    // every CPU shares the same memory
+    return 0;
+}
+
+bool set_scheduling(scheduling_policy_t policy, int priority) {
+    int native = SCHED_OTHER;
+    sched_param param {};
+    if (policy == scheduling_policy_t::fifo || policy == scheduling_policy_t::round_robin) {
+        native = policy == scheduling_policy_t::fifo ? SCHED_FIFO : SCHED_RR;
+        param.sched_priority = priority;
+    } else {
+        param.sched_priority = sched_get_priority_min(SCHED_OTHER);
+    }
+    return pthread_setschedparam(pthread_self(), native, &param) == 0;
+}
+
+scheduling_policy_t scheduling_policy() {
+    int native = SCHED_OTHER;
+    sched_param param {};
+    pthread_getschedparam(pthread_self(), &native, &param);
+    switch (native) {
+        case SCHED_FIFO: return scheduling_policy_t::fifo;
+        case SCHED_RR: return scheduling_policy_t::round_robin;
+        default: return scheduling_policy_t::normal;
+    }
+}
+
+int priority() {
+    int native = SCHED_OTHER;
+    sched_param param {};
+    pthread_getschedparam(pthread_self(), &native, &param);
+    return param.sched_priority;
+}
+
 } // namespace shard::concurrency::this_thread
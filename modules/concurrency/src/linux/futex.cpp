@@ -0,0 +1,47 @@
+// Copyright (c) 2026 Miklos Molnar. All rights reserved.
+
+#include "shard/concurrency/futex.hpp"
+
+#include <cerrno>
+#include <climits>
+#include <ctime>
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace shard::concurrency {
+
+namespace {
+
+long futex(const std::atomic<std::uint32_t>& word, int op, std::uint32_t value, const timespec* timeout) {
+    auto address = const_cast<std::atomic<std::uint32_t>*>(&word);
+    return syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(address), op, value, timeout, nullptr, 0);
+}
+
+} // namespace
+
+void futex_wait(const std::atomic<std::uint32_t>& word, std::uint32_t expected) {
+    futex(word, FUTEX_WAIT_PRIVATE, expected, nullptr);
+}
+
+bool futex_wait_for(const std::atomic<std::uint32_t>& word, std::uint32_t expected, std::chrono::nanoseconds timeout) {
+    if (timeout <= std::chrono::nanoseconds::zero()) {
+        return false;
+    }
+    auto seconds = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+    timespec ts;
+    ts.tv_sec = static_cast<time_t>(seconds.count());
+    ts.tv_nsec = static_cast<long>((timeout - seconds).count());
+    return futex(word, FUTEX_WAIT_PRIVATE, expected, &ts) == 0 || errno != ETIMEDOUT;
+}
+
+void futex_wake_one(const std::atomic<std::uint32_t>& word) {
+    futex(word, FUTEX_WAKE_PRIVATE, 1, nullptr);
+}
+
+void futex_wake_all(const std::atomic<std::uint32_t>& word) {
+    futex(word, FUTEX_WAKE_PRIVATE, INT_MAX, nullptr);
+}
+
+} // namespace shard::concurrency
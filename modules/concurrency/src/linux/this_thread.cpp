@@ -5,9 +5,26 @@
 #include <cstring>
 
 #include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 
 namespace shard::concurrency::this_thread {
 
+namespace {
+
+int native_policy(scheduling_policy_t policy) {
+    switch (policy) {
+        case scheduling_policy_t::batch: return SCHED_BATCH;
+        case scheduling_policy_t::idle: return SCHED_IDLE;
+        case scheduling_policy_t::fifo: return SCHED_FIFO;
+        case scheduling_policy_t::round_robin: return SCHED_RR;
+        default: return SCHED_OTHER;
+    }
+}
+
+} // namespace
+
 void set_name(const char* name) {
     if (const auto length = std::strlen(name); length <= 15) {
         pthread_setname_np(pthread_self(), name);
@@ -19,4 +36,73 @@ void set_name(const char* name) {
     }
 }
 
+bool set_affinity(const cpu_set& cpus) {
+    cpu_set_t native;
+    CPU_ZERO(&native);
+    for (std::size_t cpu = 0; cpu < cpu_set::max_size && cpu < CPU_SETSIZE; ++cpu) {
+        if (cpus.contains(cpu)) {
+            CPU_SET(cpu, &native);
+        }
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(native), &native) == 0;
+}
+
+cpu_set affinity() {
+    cpu_set result;
+    cpu_set_t native;
+    CPU_ZERO(&native);
+    if (pthread_getaffinity_np(pthread_self(), sizeof(native), &native) == 0) {
+        for (std::size_t cpu = 0; cpu < cpu_set::max_size && cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &native)) {
+                result.add(cpu);
+            }
+        }
+    }
+    return result;
+}
+
+std::optional<std::size_t> current_cpu() {
+    auto cpu = sched_getcpu();
+    if (cpu < 0) {
+        return std::nullopt;
+    }
+    return static_cast<std::size_t>(cpu);
+}
+
+std::optional<std::size_t> numa_node() {
+    unsigned int cpu = 0;
+    unsigned int node = 0;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0) {
+        return std::nullopt;
+    }
+    return static_cast<std::size_t>(node);
+}
+
+bool set_scheduling(scheduling_policy_t policy, int priority) {
+    auto native = native_policy(policy);
+    sched_param param {};
+    param.sched_priority = (native == SCHED_FIFO || native == SCHED_RR) ? priority : 0;
+    return pthread_setschedparam(pthread_self(), native, &param) == 0;
+}
+
+scheduling_policy_t scheduling_policy() {
+    int native = SCHED_OTHER;
+    sched_param param {};
+    pthread_getschedparam(pthread_self(), &native, &param);
+    switch (native) {
+        case SCHED_BATCH: return scheduling_policy_t::batch;
+        case SCHED_IDLE: return scheduling_policy_t::idle;
+        case SCHED_FIFO: return scheduling_policy_t::fifo;
+        case SCHED_RR: return scheduling_policy_t::round_robin;
+        default: return scheduling_policy_t::normal;
+    }
+}
+
+int priority() {
+    int native = SCHED_OTHER;
+    sched_param param {};
+    pthread_getschedparam(pthread_self(), &native, &param);
+    return param.sched_priority;
+}
+
 } // namespace shard::concurrency::this_thread
@@ -0,0 +1,42 @@
+// Copyright (c) 2026 Miklos Molnar. All rights reserved.
+
+#include "shard/concurrency/futex.hpp"
+
+#define NOMINMAX
+
+#include <windows.h>
+
+namespace shard::concurrency {
+
+namespace {
+
+void* address_of(const std::atomic<std::uint32_t>& word) {
+    return const_cast<std::atomic<std::uint32_t>*>(&word);
+}
+
+} // namespace
+
+void futex_wait(const std::atomic<std::uint32_t>& word, std::uint32_t expected) {
+    WaitOnAddress(address_of(word), &expected, sizeof(expected), INFINITE);
+}
+
+bool futex_wait_for(const std::atomic<std::uint32_t>& word, std::uint32_t expected, std::chrono::nanoseconds timeout) {
+    if (timeout <= std::chrono::nanoseconds::zero()) {
+        return false;
+    }
+    // round up so that short timeouts do not turn into busy waiting
+    auto ms = std::chrono::ceil<std::chrono::milliseconds>(timeout).count();
+    auto limit = static_cast<long long>(INFINITE - 1);
+    auto duration = static_cast<DWORD>(ms < limit ? ms : limit);
+    return WaitOnAddress(address_of(word), &expected, sizeof(expected), duration) || GetLastError() != ERROR_TIMEOUT;
+}
+
+void futex_wake_one(const std::atomic<std::uint32_t>& word) {
+    WakeByAddressSingle(address_of(word));
+}
+
+void futex_wake_all(const std::atomic<std::uint32_t>& word) {
+    WakeByAddressAll(address_of(word));
+}
+
+} // namespace shard::concurrency
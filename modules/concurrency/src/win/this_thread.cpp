@@ -2,6 +2,8 @@
 
 #include "shard/concurrency/this_thread.hpp"
 
+#define NOMINMAX
+
 #include <windows.h>
 
 #pragma pack(push, 8)
@@ -34,4 +36,79 @@ void set_name(const char* name) {
 #endif
 }
 
+bool set_affinity(const cpu_set& cpus) {
+    // only the first processor group is supported
+    DWORD_PTR mask = 0;
+    for (std::size_t cpu = 0; cpu < sizeof(DWORD_PTR) * 8; ++cpu) {
+        if (cpus.contains(cpu)) {
+            mask |= DWORD_PTR(1) << cpu;
+        }
+    }
+    return mask != 0 && SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+}
+
+cpu_set affinity() {
+    cpu_set result;
+    DWORD_PTR process_mask = 0;
+    DWORD_PTR system_mask = 0;
+    if (GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask)) {
+        // there is no getter for threads, setting the mask returns the old one
+        auto mask = SetThreadAffinityMask(GetCurrentThread(), process_mask);
+        if (mask != 0) {
+            SetThreadAffinityMask(GetCurrentThread(), mask);
+        } else {
+            mask = process_mask;
+        }
+        for (std::size_t cpu = 0; cpu < sizeof(DWORD_PTR) * 8; ++cpu) {
+            if ((mask & (DWORD_PTR(1) << cpu)) != 0) {
+                result.add(cpu);
+            }
+        }
+    }
+    return result;
+}
+
+std::optional<std::size_t> current_cpu() {
+    return static_cast<std::size_t>(GetCurrentProcessorNumber());
+}
+
+std::optional<std::size_t> numa_node() {
+    PROCESSOR_NUMBER processor;
+    GetCurrentProcessorNumberEx(&processor);
+    USHORT node = 0;
+    if (!GetNumaProcessorNodeEx(&processor, &node)) {
+        return std::nullopt;
+    }
+    return static_cast<std::size_t>(node);
+}
+
+bool set_scheduling(scheduling_policy_t policy, int priority) {
+    // map the policies to the closest thread priorities
+    int native = THREAD_PRIORITY_NORMAL;
+    switch (policy) {
+        case scheduling_policy_t::batch: native = THREAD_PRIORITY_BELOW_NORMAL; break;
+        case scheduling_policy_t::idle: native = THREAD_PRIORITY_IDLE; break;
+        case scheduling_policy_t::fifo:
+        case scheduling_policy_t::round_robin:
+            native = priority > 0 ? THREAD_PRIORITY_TIME_CRITICAL : THREAD_PRIORITY_HIGHEST;
+            break;
+        default: break;
+    }
+    return SetThreadPriority(GetCurrentThread(), native) != 0;
+}
+
+scheduling_policy_t scheduling_policy() {
+    switch (GetThreadPriority(GetCurrentThread())) {
+        case THREAD_PRIORITY_BELOW_NORMAL: return scheduling_policy_t::batch;
+        case THREAD_PRIORITY_IDLE: return scheduling_policy_t::idle;
+        case THREAD_PRIORITY_HIGHEST:
+        case THREAD_PRIORITY_TIME_CRITICAL: return scheduling_policy_t::fifo;
+        default: return scheduling_policy_t::normal;
+    }
+}
+
+int priority() {
+    return GetThreadPriority(GetCurrentThread());
+}
+
 } // namespace shard::concurrency::this_thread
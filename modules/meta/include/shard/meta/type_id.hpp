@@ -6,6 +6,7 @@
 #include <cassert>
 #include <cstdint>
 #include <functional>
+#include <limits>
 
 namespace shard {
 namespace meta {
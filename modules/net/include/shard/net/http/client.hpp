@@ -13,8 +13,10 @@
 
 #include <chrono>
 #include <cstddef>
+#include <iterator>
 #include <mutex>
 #include <thread>
+#include <vector>
 
 namespace shard::net::http {
 
@@ -103,8 +105,17 @@ private:
     }
 
     void worker_thread() {
-        while (auto request = m_requests.pop()) {
-            perform_request(std::move(*request));
+        std::vector<request> requests;
+        requests.reserve(max_batch_size);
+        while (m_requests.pop_batch(std::back_inserter(requests), max_batch_size) != 0) {
+            for (auto& r : requests) {
+                // stop processing the batch once the client is destroyed
+                if (!m_requests.is_open()) {
+                    break;
+                }
+                perform_request(std::move(r));
+            }
+            requests.clear();
         }
     }
 
@@ -232,6 +243,9 @@ private:
         curl::proxy_t type = curl::proxy_t::http;
     };
 
+    // the maximum number of requests taken from the queue at once
+    static constexpr std::size_t max_batch_size = 16;
+
 private:
     curl::handle m_curl;
     std::recursive_mutex m_mutex;
@@ -2,21 +2,124 @@
 
 #include "helpers/widget.hpp"
 
+#include <shard/alloc/allocators/arena_allocator.hpp>
+#include <shard/alloc/allocators/buddy_allocator.hpp>
 #include <shard/alloc/allocators/free_list_allocator.hpp>
 #include <shard/alloc/allocators/heap_allocator.hpp>
 #include <shard/alloc/allocators/linear_allocator.hpp>
 #include <shard/alloc/allocators/pool_allocator.hpp>
 #include <shard/alloc/allocators/proxy_allocator.hpp>
+#include <shard/alloc/allocators/slab_allocator.hpp>
 #include <shard/alloc/allocators/static_allocator.hpp>
+#include <shard/alloc/allocators/thread_caching_allocator.hpp>
+#include <shard/alloc/allocators/tlsf_allocator.hpp>
 
 #include <doctest.h>
 
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <vector>
+
 #define BUFFER_SIZE 512
 
 // statically allocated buffer
 static char g_buffer[BUFFER_SIZE];
 
 TEST_CASE("alloc.allocators") {
+    SUBCASE("arena_allocator") {
+        shard::heap_allocator upstream;
+        {
+            shard::arena_allocator a(upstream, 256);
+            REQUIRE(a.size() == 0);
+            REQUIRE(a.used_memory() == 0);
+            REQUIRE(a.allocation_count() == 0);
+
+            auto w = shard::new_object<test::widget>(a, 3, 42);
+            REQUIRE(a.size() == 256);
+            REQUIRE(a.used_memory() == sizeof(test::widget));
+            REQUIRE(a.allocation_count() == 1);
+
+            REQUIRE(w->a == 3);
+            REQUIRE(w->b == 42);
+
+            // grows geometrically once the first block is full
+            auto m = a.mark();
+            for (auto i = 0; i < 30; ++i) {
+                REQUIRE(a.allocate(32, 16));
+            }
+            REQUIRE(a.block_count() == 3);
+            REQUIRE(a.size() == 256 + 512 + 1024);
+            REQUIRE(a.allocation_count() == 31);
+
+            // blocks larger than the next one
+            auto large = a.allocate(5000, 8);
+            REQUIRE(large);
+            REQUIRE(a.block_count() == 4);
+
+            a.rewind(m);
+            REQUIRE(a.used_memory() == sizeof(test::widget));
+            REQUIRE(a.allocation_count() == 1);
+            // only the largest released block is kept
+            REQUIRE(a.block_count() == 2);
+            REQUIRE(upstream.allocation_count() == 2);
+            REQUIRE(a.allocate(8, 8) == shard::memory::add(w, sizeof(test::widget)));
+
+            a.reset();
+            REQUIRE(a.used_memory() == 0);
+            REQUIRE(a.allocation_count() == 0);
+            REQUIRE(a.block_count() == 1);
+            REQUIRE(upstream.allocation_count() == 1);
+            REQUIRE(a.allocate(4096, 8));
+            REQUIRE(a.block_count() == 1);
+        }
+        REQUIRE(upstream.allocation_count() == 0);
+    }
+
+    SUBCASE("buddy_allocator") {
+        shard::buddy_allocator a(g_buffer, BUFFER_SIZE, 32);
+        REQUIRE(a.size() == BUFFER_SIZE);
+        REQUIRE(a.used_memory() == 0);
+        REQUIRE(a.allocation_count() == 0);
+        REQUIRE(a.min_block_size() == 32);
+        // the bookkeeping takes the first blocks
+        REQUIRE(a.max_block_size() == 256);
+
+        auto w = shard::new_object<test::widget>(a, 3, 42);
+        REQUIRE(a.used_memory() == 32);
+        REQUIRE(a.allocation_count() == 1);
+
+        REQUIRE(w->a == 3);
+        REQUIRE(w->b == 42);
+
+        shard::delete_object(a, w);
+        REQUIRE(a.used_memory() == 0);
+        REQUIRE(a.allocation_count() == 0);
+
+        // rounded up to the next power of two
+        REQUIRE(a.block_size_for(33) == 64);
+        auto p = a.allocate(33, 8);
+        auto q = a.allocate(100, 32);
+        REQUIRE(shard::memory::is_aligned(q, 32));
+        REQUIRE(a.used_memory() == 64 + 128);
+        REQUIRE_FALSE(a.allocate(8, 64));
+
+        // the rounding is the internal fragmentation
+        REQUIRE(a.requested_memory() == 33 + 100);
+        REQUIRE(a.used_memory() - a.requested_memory() == 31 + 28);
+
+        // the blocks are merged with their buddies when freed
+        a.deallocate(p);
+        REQUIRE(a.requested_memory() == 100);
+        a.deallocate(q);
+        REQUIRE(a.requested_memory() == 0);
+        auto largest = a.allocate(256, 8);
+        REQUIRE(largest);
+        a.deallocate(largest);
+        REQUIRE(a.used_memory() == 0);
+        REQUIRE(a.allocation_count() == 0);
+    }
+
     SUBCASE("free_list_allocator") {
         shard::free_list_allocator a(g_buffer, BUFFER_SIZE);
         REQUIRE(a.size() == BUFFER_SIZE);
@@ -115,6 +218,58 @@ TEST_CASE("alloc.allocators") {
         REQUIRE(proxy.allocation_count() == 0);
     }
 
+    SUBCASE("slab_allocator") {
+        shard::heap_allocator backing;
+        {
+            shard::slab_allocator a(backing, 4096, 2);
+            REQUIRE(a.size() == 0);
+            REQUIRE(a.used_memory() == 0);
+            REQUIRE(a.allocation_count() == 0);
+
+            auto w = shard::new_object<test::widget>(a, 3, 42);
+            REQUIRE(a.size() == 2 * 4096);
+            REQUIRE(a.used_memory() == shard::slab_allocator::block_size(sizeof(test::widget), alignof(test::widget)));
+            REQUIRE(a.allocation_count() == 1);
+            REQUIRE(backing.allocation_count() == 1);
+
+            REQUIRE(w->a == 3);
+            REQUIRE(w->b == 42);
+
+            shard::delete_object(a, w);
+            REQUIRE(a.used_memory() == 0);
+            REQUIRE(a.allocation_count() == 0);
+
+            // size classes
+            REQUIRE(shard::slab_allocator::block_size(1, 1) == 16);
+            REQUIRE(shard::slab_allocator::block_size(100, 8) == 112);
+            REQUIRE(shard::slab_allocator::block_size(40, 32) == 64);
+            REQUIRE(shard::slab_allocator::block_size(2000, 8) == 0);
+            REQUIRE_FALSE(a.allocate(2000, 8));
+
+            // freed objects are reused
+            auto p = a.allocate(24, 8);
+            a.deallocate(p);
+            REQUIRE(a.allocate(24, 8) == p);
+            a.deallocate(p);
+
+            // more objects than a chunk holds
+            void* blocks[200];
+            for (auto& b : blocks) {
+                b = a.allocate(64, 64);
+                REQUIRE(b);
+                REQUIRE(shard::memory::is_aligned(b, 64));
+            }
+            REQUIRE(a.size() > 2 * 4096);
+            REQUIRE(a.used_memory() == 200 * 64);
+            for (auto b : blocks) {
+                a.deallocate(b);
+            }
+            REQUIRE(a.used_memory() == 0);
+            REQUIRE(a.allocation_count() == 0);
+        }
+        REQUIRE(backing.allocation_count() == 0);
+    }
+
     SUBCASE("static_allocator") {
         shard::static_allocator<BUFFER_SIZE> a;
         REQUIRE(a.size() == BUFFER_SIZE);
@@ -136,4 +291,181 @@ TEST_CASE("alloc.allocators") {
         REQUIRE(a.used_memory() == 0);
         REQUIRE(a.allocation_count() == 0);
     }
+
+    SUBCASE("thread_caching_allocator") {
+        shard::heap_allocator backing;
+        {
+            shard::thread_caching_allocator a(backing);
+            REQUIRE(a.size() == 0);
+            REQUIRE(a.used_memory() == 0);
+            REQUIRE(a.allocation_count() == 0);
+
+            auto w = shard::new_object<test::widget>(a, 3, 42);
+            REQUIRE(w->a == 3);
+            REQUIRE(w->b == 42);
+            REQUIRE(shard::memory::is_aligned(w, 16));
+            a.flush();
+            REQUIRE(a.used_memory() == 16);
+            REQUIRE(a.allocation_count() == 1);
+
+            shard::delete_object(a, w);
+            a.flush();
+            REQUIRE(a.used_memory() == 0);
+            REQUIRE(a.allocation_count() == 0);
+            REQUIRE(backing.allocation_count() == 0);
+
+            // large and over-aligned allocations bypass the caches
+            auto large = a.allocate(100000, 8);
+            auto aligned = a.allocate(64, 64);
+            REQUIRE(shard::memory::is_aligned(aligned, 64));
+            REQUIRE(a.allocation_count() == 2);
+            a.deallocate(large);
+            a.deallocate(aligned);
+            REQUIRE(a.used_memory() == 0);
+            REQUIRE(a.allocation_count() == 0);
+
+            // blocks freed by other threads go back to their owner
+            constexpr auto count = 1000;
+            std::vector<void*> blocks(count);
+            std::thread producer([&] {
+                for (auto& b : blocks) {
+                    b = a.allocate(48, 8);
+                }
+            });
+            producer.join();
+            std::thread consumer([&] {
+                for (auto b : blocks) {
+                    a.deallocate(b);
+                }
+                a.flush();
+            });
+            consumer.join();
+            for (auto i = 0; i < count; ++i) {
+                blocks[i] = a.allocate(48, 8);
+            }
+            for (auto b : blocks) {
+                a.deallocate(b);
+            }
+            a.flush();
+            REQUIRE(a.used_memory() == 0);
+            REQUIRE(a.allocation_count() == 0);
+
+            // the blocks taken back from other threads do not overflow the
+            // cache
+            auto before = backing.allocation_count();
+            for (auto& b : blocks) {
+                b = a.allocate(48, 8);
+            }
+            std::thread([&] {
+                for (auto b : blocks) {
+                    a.deallocate(b);
+                }
+            }).join();
+            // the cache holds 8 blocks of the last refill, then it collects
+            // the 1000 freed blocks and keeps half its capacity
+            std::vector<void*> more;
+            for (auto i = 0; i < 9; ++i) {
+                more.push_back(a.allocate(48, 8));
+            }
+            REQUIRE(backing.allocation_count() == before + 9 + shard::thread_caching_allocator::cache_capacity / 2 - 1);
+            REQUIRE(a.stats().allocation_count == more.size());
+            REQUIRE(a.stats().used_memory == 64 * more.size());
+            for (auto b : more) {
+                a.deallocate(b);
+            }
+            a.flush();
+            REQUIRE(a.stats().allocation_count == 0);
+
+            // the caches of exited threads are released, even if their
+            // blocks are freed after the thread is gone
+            void* survivor = nullptr;
+            for (auto i = 0; i < 8; ++i) {
+                std::thread([&] {
+                    for (auto& b : blocks) {
+                        b = a.allocate(48, 8);
+                    }
+                    for (auto b : blocks) {
+                        a.deallocate(b);
+                    }
+                    if (!survivor) {
+                        survivor = a.allocate(32, 8);
+                    }
+                }).join();
+            }
+            a.flush();
+            REQUIRE(backing.allocation_count() == 1);
+            a.deallocate(survivor);
+            a.flush();
+            REQUIRE(backing.allocation_count() == 0);
+            REQUIRE(a.used_memory() == 0);
+            REQUIRE(a.allocation_count() == 0);
+        }
+        REQUIRE(backing.allocation_count() == 0);
+    }
+
+    SUBCASE("tlsf_allocator") {
+        shard::tlsf_allocator a(g_buffer, BUFFER_SIZE);
+        REQUIRE(a.size() == BUFFER_SIZE);
+        REQUIRE(a.used_memory() == 0);
+        REQUIRE(a.allocation_count() == 0);
+
+        auto w = shard::new_object<test::widget>(a, 3, 42);
+        // 16 is the size of the block header, blocks are at least 32 bytes
+        REQUIRE(a.used_memory() == 32);
+        REQUIRE(a.allocation_count() == 1);
+
+        REQUIRE(w->a == 3);
+        REQUIRE(w->b == 42);
+
+        shard::delete_object(a, w);
+        REQUIRE(a.used_memory() == 0);
+        REQUIRE(a.allocation_count() == 0);
+
+        // the freed blocks are merged, so the whole buffer is available again
+        auto p = a.allocate(BUFFER_SIZE - 64, 8);
+        REQUIRE(p);
+        REQUIRE_FALSE(a.allocate(64, 8));
+        a.deallocate(p);
+
+        auto aligned = a.allocate(24, 64);
+        REQUIRE(shard::memory::is_aligned(aligned, 64));
+        a.deallocate(aligned);
+        REQUIRE(a.allocation_count() == 0);
+    }
+
+    SUBCASE("tlsf_allocator random") {
+        static char buffer[1 << 16];
+        shard::tlsf_allocator a(buffer, sizeof(buffer));
+        std::mt19937 rng(42);
+        std::vector<std::pair<unsigned char*, std::size_t>> live;
+        for (auto i = 0; i < 5000; ++i) {
+            if (live.empty() || rng() % 3 != 0) {
+                auto size = 1 + rng() % 700;
+                auto align = std::size_t(1) << (rng() % 7);
+                auto p = static_cast<unsigned char*>(a.allocate(size, align));
+                if (p) {
+                    REQUIRE(shard::memory::is_aligned(p, align));
+                    std::fill(p, p + size, static_cast<unsigned char>(i));
+                    live.emplace_back(p, size);
+                }
+            } else {
+                auto index = rng() % live.size();
+                auto [p, size] = live[index];
+                // the memory was not overwritten by other allocations
+                REQUIRE(std::count(p, p + size, p[0]) == static_cast<std::ptrdiff_t>(size));
+                a.deallocate(p);
+                live[index] = live.back();
+                live.pop_back();
+            }
+        }
+        for (auto [p, size] : live) {
+            a.deallocate(p);
+        }
+        REQUIRE(a.used_memory() == 0);
+        REQUIRE(a.allocation_count() == 0);
+        // everything is merged back into a single block
+        auto p = a.allocate(sizeof(buffer) * 3 / 4, 8);
+        REQUIRE(p);
+        a.deallocate(p);
+    }
 }
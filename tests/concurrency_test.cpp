@@ -4,11 +4,40 @@
 #include "helpers/widget.hpp"
 
 #include <shard/concurrency.hpp>
+#include <shard/algorithm/enumerate.hpp>
+#include <shard/concurrency/parallel.hpp>
+#include <shard/concurrency/task_graph.hpp>
+#include <shard/concurrency/thread_pool.hpp>
+#include <shard/utility/span.hpp>
 
 #include <doctest.h>
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <list>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
 #include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+template <typename Predicate>
+static bool wait_until(Predicate predicate, std::chrono::milliseconds timeout = std::chrono::milliseconds(5000)) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!predicate()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::yield();
+    }
+    return true;
+}
 
 static void channel_writer(shard::channel<int>* channel, int i) {
     std::this_thread::sleep_for(std::chrono::milliseconds(10));
@@ -49,6 +78,92 @@ TEST_CASE("concurrency") {
             REQUIRE(n->a == 42);
             REQUIRE(n->b == 21);
         }
+
+        SUBCASE("pop_for") {
+            REQUIRE_FALSE(channel.pop_for(std::chrono::milliseconds(10)));
+            channel.push(42);
+            int n = -1;
+            REQUIRE(channel.pop_for(n, std::chrono::milliseconds(10)));
+            REQUIRE(n == 42);
+        }
+
+        SUBCASE("pop_batch") {
+            for (auto i = 0; i < 5; ++i) {
+                channel.push(i);
+            }
+            std::vector<int> values;
+            REQUIRE(channel.pop_batch(std::back_inserter(values), 3) == 3);
+            REQUIRE(channel.pop_batch(std::back_inserter(values), 3) == 2);
+            REQUIRE(values == std::vector<int> {0, 1, 2, 3, 4});
+            channel.close();
+            REQUIRE(channel.pop_batch(std::back_inserter(values), 3) == 0);
+        }
+
+        SUBCASE("bounded") {
+            shard::channel<int> bounded(2);
+            REQUIRE(bounded.is_bounded());
+            REQUIRE(bounded.capacity() == 2);
+            REQUIRE(bounded.try_push(1));
+            REQUIRE(bounded.push(2));
+            REQUIRE_FALSE(bounded.try_push(3));
+            REQUIRE_FALSE(bounded.try_push_for(3, std::chrono::milliseconds(10)));
+
+            // a blocked producer is released by the consumer
+            std::thread thread([&bounded] { bounded.push(3); });
+            REQUIRE(wait_until([&] { return bounded.pop_for(std::chrono::milliseconds(10)).has_value(); }));
+            thread.join();
+            REQUIRE(bounded.size() == 2);
+
+            // a blocked producer is released by closing the channel
+            std::atomic<bool> pushed = true;
+            std::thread closed([&] { pushed = bounded.push(4); });
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            bounded.close();
+            closed.join();
+            REQUIRE_FALSE(pushed);
+        }
+
+        SUBCASE("select") {
+            shard::channel<std::string> other;
+            REQUIRE_FALSE(shard::select_for(std::chrono::milliseconds(10), channel, other));
+
+            other.push("hello");
+            REQUIRE(shard::select(channel, other) == 1u);
+            channel.push(42);
+            REQUIRE(shard::select(channel, other) == 0u);
+            channel.pop();
+            other.pop();
+
+            std::thread thread([&other] {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                other.push("world");
+            });
+            REQUIRE(shard::select_for(std::chrono::seconds(5), channel, other) == 1u);
+            REQUIRE(other.try_pop() == "world");
+            thread.join();
+
+            std::thread closing([&] {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                channel.close();
+                other.close();
+            });
+            REQUIRE_FALSE(shard::select(channel, other));
+            closing.join();
+        }
+
+        SUBCASE("metrics") {
+            for (auto i = 0; i < 5; ++i) {
+                channel.push(i);
+            }
+            channel.pop();
+            std::vector<int> values;
+            channel.pop_batch(std::back_inserter(values), 2);
+            auto metrics = channel.metrics();
+            REQUIRE(metrics.pushed == 5);
+            REQUIRE(metrics.popped == 3);
+            REQUIRE(metrics.size == 2);
+            REQUIRE(metrics.waiting_producers == 0);
+        }
     }
 
     SUBCASE("mpsc_queue") {
@@ -85,6 +200,1040 @@ TEST_CASE("concurrency") {
             }
             REQUIRE(queue.is_empty());
         }
+
+        SUBCASE("pop_wait") {
+            REQUIRE_FALSE(queue.pop_wait(std::chrono::milliseconds(10)));
+
+            std::thread thread([&queue] {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                queue.emplace(1);
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                queue.emplace(2);
+            });
+            auto value = queue.pop_wait(std::chrono::seconds(5));
+            REQUIRE(value.has_value());
+            REQUIRE(value->a == 1);
+            REQUIRE(queue.pop_wait().a == 2);
+            thread.join();
+        }
+
+        SUBCASE("drain") {
+            queue.emplace(1);
+            queue.emplace(2);
+            queue.emplace(3);
+
+            std::vector<test::widget> output;
+            REQUIRE(queue.drain(std::back_inserter(output), 2) == 2);
+            REQUIRE(output.size() == 2);
+            REQUIRE(output[1].a == 2);
+            REQUIRE(queue.size() == 1);
+            REQUIRE(queue.drain(std::back_inserter(output), 8) == 1);
+            REQUIRE(queue.is_empty());
+        }
+
+        SUBCASE("destroying items") {
+            auto item = std::make_shared<int>(42);
+            {
+                shard::mpsc_queue<std::shared_ptr<int>, 4> owner;
+                owner.push(item);
+                owner.push(item);
+                REQUIRE(item.use_count() == 3);
+                owner.pop();
+                REQUIRE(item.use_count() == 2);
+            }
+            REQUIRE(item.use_count() == 1);
+        }
+    }
+
+    SUBCASE("unbounded_mpsc_queue") {
+        shard::unbounded_mpsc_queue<test::widget, 4> queue;
+
+        SUBCASE("push and pop") {
+            REQUIRE(queue.is_empty());
+            REQUIRE_FALSE(queue.pop());
+            // spans multiple segments
+            for (auto i = 0; i < 10; ++i) {
+                queue.emplace(i);
+            }
+            REQUIRE(queue.size() == 10);
+            for (auto i = 0; i < 10; ++i) {
+                auto value = queue.pop();
+                REQUIRE(value.has_value());
+                REQUIRE(value->a == i);
+            }
+            REQUIRE(queue.is_empty());
+            REQUIRE_FALSE(queue.pop());
+
+            // the consumed segments are reused
+            queue.push(test::widget {10});
+            REQUIRE(queue.pop()->a == 10);
+        }
+
+        SUBCASE("drain") {
+            for (auto i = 0; i < 6; ++i) {
+                queue.emplace(i);
+            }
+            std::vector<test::widget> output;
+            REQUIRE(queue.drain(std::back_inserter(output), 5) == 5);
+            REQUIRE(output[4].a == 4);
+            REQUIRE(queue.drain(std::back_inserter(output), 5) == 1);
+            REQUIRE(queue.is_empty());
+        }
+
+        SUBCASE("destroying items") {
+            auto item = std::make_shared<int>(42);
+            {
+                shard::unbounded_mpsc_queue<std::shared_ptr<int>, 2> owner;
+                for (auto i = 0; i < 5; ++i) {
+                    owner.push(item);
+                }
+                owner.pop();
+                REQUIRE(item.use_count() == 5);
+            }
+            REQUIRE(item.use_count() == 1);
+        }
+
+        SUBCASE("throwing constructor") {
+            struct checked {
+                explicit checked(int value)
+                : value(value) {
+                    if (value < 0) {
+                        throw std::invalid_argument("negative");
+                    }
+                }
+
+                int value;
+            };
+
+            shard::unbounded_mpsc_queue<checked, 2> checked_queue;
+            checked_queue.emplace(1);
+            REQUIRE_THROWS_AS(checked_queue.emplace(-1), std::invalid_argument);
+            checked_queue.emplace(2);
+            checked_queue.emplace(3);
+            REQUIRE(checked_queue.size() == 3);
+            for (auto i = 1; i <= 3; ++i) {
+                REQUIRE(checked_queue.pop()->value == i);
+            }
+            REQUIRE_FALSE(checked_queue.pop());
+        }
+
+        SUBCASE("multiple producers") {
+            shard::unbounded_mpsc_queue<int, 16> shared;
+            constexpr auto per_thread = 5000;
+            std::vector<std::thread> producers;
+            for (auto t = 0; t < 3; ++t) {
+                producers.emplace_back([&shared] {
+                    for (auto i = 1; i <= per_thread; ++i) {
+                        shared.push(i);
+                    }
+                });
+            }
+            long long sum = 0;
+            for (auto consumed = 0; consumed < 3 * per_thread;) {
+                if (auto value = shared.pop()) {
+                    sum += *value;
+                    ++consumed;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+            for (auto& thread : producers) {
+                thread.join();
+            }
+            REQUIRE(sum == 3LL * per_thread * (per_thread + 1) / 2);
+            REQUIRE(shared.is_empty());
+        }
+    }
+
+    SUBCASE("mpmc_queue") {
+        shard::mpmc_queue<test::widget, 8> queue;
+
+        SUBCASE("size") {
+            REQUIRE(queue.is_empty());
+            REQUIRE(queue.size() == 0);
+            REQUIRE(queue.capacity() == 8);
+        }
+
+        SUBCASE("push and pop") {
+            REQUIRE(queue.try_push(test::widget {1}));
+            REQUIRE(queue.try_emplace(2));
+            REQUIRE(queue.size() == 2);
+
+            auto value = queue.try_pop();
+            REQUIRE(value.has_value());
+            REQUIRE(value->a == 1);
+
+            test::widget w;
+            REQUIRE(queue.try_pop(w));
+            REQUIRE(w.a == 2);
+            REQUIRE_FALSE(queue.try_pop());
+        }
+
+        SUBCASE("full") {
+            for (auto i = 0; i < 8; ++i) {
+                REQUIRE(queue.try_emplace(i));
+            }
+            REQUIRE_FALSE(queue.try_emplace(8));
+            REQUIRE(queue.try_pop()->a == 0);
+            REQUIRE(queue.try_emplace(8));
+        }
+
+        SUBCASE("batch") {
+            std::vector<test::widget> input = {test::widget {1}, test::widget {2}, test::widget {3}};
+            REQUIRE(queue.try_push_batch(input.begin(), input.end()) == input.end());
+
+            std::vector<test::widget> output;
+            REQUIRE(queue.try_pop_batch(std::back_inserter(output), 2) == 2);
+            REQUIRE(output.size() == 2);
+            REQUIRE(output[0].a == 1);
+            REQUIRE(output[1].a == 2);
+            REQUIRE(queue.size() == 1);
+        }
+
+        SUBCASE("throwing constructor") {
+            struct checked {
+                explicit checked(int value)
+                : value(value) {
+                    if (value < 0) {
+                        throw std::invalid_argument("negative");
+                    }
+                }
+
+                int value;
+            };
+
+            shard::mpmc_queue<checked, 4> checked_queue;
+            REQUIRE_THROWS_AS(checked_queue.try_emplace(-1), std::invalid_argument);
+            std::vector<int> input = {1, -2, 3};
+            REQUIRE_THROWS_AS(checked_queue.try_push_batch(input.begin(), input.end()), std::invalid_argument);
+
+            // the failed items did not claim a slot
+            REQUIRE(checked_queue.size() == 1);
+            REQUIRE(checked_queue.try_emplace(4));
+            REQUIRE(checked_queue.try_pop()->value == 1);
+            REQUIRE(checked_queue.try_pop()->value == 4);
+            REQUIRE(checked_queue.is_empty());
+        }
+
+        SUBCASE("multiple producers and consumers") {
+            shard::mpmc_queue<int, 64> shared;
+            constexpr auto per_thread = 2000;
+            std::atomic<long long> sum = 0;
+            std::atomic<int> consumed = 0;
+
+            std::vector<std::thread> threads;
+            for (auto t = 0; t < 2; ++t) {
+                threads.emplace_back([&shared] {
+                    for (auto i = 1; i <= per_thread;) {
+                        if (shared.try_push(i)) {
+                            ++i;
+                        } else {
+                            std::this_thread::yield();
+                        }
+                    }
+                });
+                threads.emplace_back([&] {
+                    int values[8];
+                    while (consumed < 2 * per_thread) {
+                        auto count = shared.try_pop_batch(values, 8);
+                        if (count == 0) {
+                            std::this_thread::yield();
+                        }
+                        for (std::size_t i = 0; i < count; ++i) {
+                            sum += values[i];
+                        }
+                        consumed += static_cast<int>(count);
+                    }
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            REQUIRE(sum == 2LL * per_thread * (per_thread + 1) / 2);
+        }
+    }
+
+    SUBCASE("spsc_queue") {
+        shard::spsc_queue<test::widget> queue(6);
+
+        SUBCASE("size") {
+            REQUIRE(queue.is_empty());
+            REQUIRE(queue.size() == 0);
+            REQUIRE(queue.capacity() == 8);
+        }
+
+        SUBCASE("push and pop") {
+            REQUIRE(queue.try_push(test::widget {1}));
+            REQUIRE(queue.try_emplace(2));
+            REQUIRE(queue.size() == 2);
+
+            auto value = queue.try_pop();
+            REQUIRE(value.has_value());
+            REQUIRE(value->a == 1);
+
+            test::widget w;
+            REQUIRE(queue.try_pop(w));
+            REQUIRE(w.a == 2);
+            REQUIRE_FALSE(queue.try_pop());
+        }
+
+        SUBCASE("full") {
+            for (auto i = 0; i < 8; ++i) {
+                REQUIRE(queue.try_emplace(i));
+            }
+            REQUIRE_FALSE(queue.try_emplace(8));
+            REQUIRE(queue.try_pop()->a == 0);
+            REQUIRE(queue.try_emplace(8));
+        }
+
+        SUBCASE("write and read") {
+            // move the indices so that the transfers wrap around
+            for (auto i = 0; i < 6; ++i) {
+                REQUIRE(queue.try_emplace(i));
+                REQUIRE(queue.try_pop());
+            }
+
+            std::vector<test::widget> input = {test::widget {1}, test::widget {2}, test::widget {3}};
+            REQUIRE(queue.write(input) == 3);
+            REQUIRE(queue.write(input) == 3);
+            REQUIRE(queue.write(input) == 2);
+            REQUIRE(queue.size() == 8);
+
+            std::vector<test::widget> output(5);
+            REQUIRE(queue.read(output) == 5);
+            REQUIRE(output[0].a == 1);
+            REQUIRE(output[3].a == 1);
+            REQUIRE(output[4].a == 2);
+            REQUIRE(queue.read(output) == 3);
+            REQUIRE(output[2].a == 2);
+            REQUIRE(queue.is_empty());
+        }
+
+        SUBCASE("throwing assignment") {
+            struct fragile {
+                fragile() = default;
+
+                explicit fragile(int value)
+                : value(value) {}
+
+                fragile(fragile&&) = default;
+
+                fragile& operator=(fragile&& other) {
+                    if (other.value < 0) {
+                        throw std::runtime_error("negative");
+                    }
+                    value = other.value;
+                    return *this;
+                }
+
+                int value = 0;
+            };
+
+            shard::spsc_queue<fragile> fragile_queue(4);
+            REQUIRE(fragile_queue.try_emplace(1));
+            REQUIRE(fragile_queue.try_emplace(-2));
+            REQUIRE(fragile_queue.try_emplace(3));
+
+            std::vector<fragile> output(3);
+            REQUIRE_THROWS_AS(fragile_queue.read(output), std::runtime_error);
+            REQUIRE(output[0].value == 1);
+            // the moved item is gone, the failed one is kept
+            REQUIRE(fragile_queue.size() == 2);
+            REQUIRE(fragile_queue.try_pop()->value == -2);
+            REQUIRE(fragile_queue.try_pop()->value == 3);
+        }
+
+        SUBCASE("byte ring") {
+            shard::spsc_queue<std::byte> ring(8);
+            for (auto i = 0; i < 6; ++i) {
+                REQUIRE(ring.try_push(std::byte {0}));
+                REQUIRE(ring.try_pop());
+            }
+
+            auto region = ring.write_region();
+            REQUIRE(region.size() == 2);
+            region[0] = std::byte {1};
+            region[1] = std::byte {2};
+            ring.commit_write(2);
+
+            region = ring.write_region();
+            REQUIRE(region.size() == 6);
+            region[0] = std::byte {3};
+            ring.commit_write(1);
+
+            auto filled = ring.read_region();
+            REQUIRE(filled.size() == 2);
+            REQUIRE(filled[1] == std::byte {2});
+            ring.commit_read(2);
+
+            filled = ring.read_region();
+            REQUIRE(filled.size() == 1);
+            REQUIRE(filled[0] == std::byte {3});
+            ring.commit_read(1);
+            REQUIRE(ring.is_empty());
+        }
+
+        SUBCASE("producer and consumer") {
+            shard::spsc_queue<int> shared(64);
+            constexpr auto count = 10000;
+            long long sum = 0;
+
+            std::thread producer([&shared] {
+                int values[16];
+                for (auto i = 1; i <= count;) {
+                    auto n = 0;
+                    while (n < 16 && i + n <= count) {
+                        values[n] = i + n;
+                        ++n;
+                    }
+                    auto written = shared.write(shard::span<const int>(values, n));
+                    if (written == 0) {
+                        std::this_thread::yield();
+                    }
+                    i += static_cast<int>(written);
+                }
+            });
+
+            int values[16];
+            for (auto received = 0; received < count;) {
+                auto n = shared.read(values);
+                if (n == 0) {
+                    std::this_thread::yield();
+                }
+                for (std::size_t i = 0; i < n; ++i) {
+                    sum += values[i];
+                }
+                received += static_cast<int>(n);
+            }
+            producer.join();
+            REQUIRE(sum == 1LL * count * (count + 1) / 2);
+        }
+    }
+
+    SUBCASE("lightweight_semaphore") {
+        shard::lightweight_semaphore semaphore(1);
+        REQUIRE(semaphore.try_acquire());
+        REQUIRE_FALSE(semaphore.try_acquire());
+        REQUIRE_FALSE(semaphore.try_acquire_for(std::chrono::milliseconds(10)));
+
+        std::atomic<int> acquired = 0;
+        std::vector<std::thread> threads;
+        for (auto i = 0; i < 3; ++i) {
+            threads.emplace_back([&] {
+                semaphore.acquire();
+                ++acquired;
+            });
+        }
+        semaphore.release(2);
+        REQUIRE(wait_until([&] { return acquired == 2; }));
+        REQUIRE(semaphore.try_acquire_for(std::chrono::milliseconds(10)) == false);
+        semaphore.release();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        REQUIRE(acquired == 3);
+    }
+
+    SUBCASE("latch") {
+        shard::latch latch(3);
+        REQUIRE_FALSE(latch.try_wait());
+
+        std::atomic<int> count = 0;
+        std::vector<std::thread> threads;
+        for (auto i = 0; i < 2; ++i) {
+            threads.emplace_back([&] {
+                ++count;
+                latch.arrive_and_wait();
+            });
+        }
+        latch.count_down();
+        latch.wait();
+        REQUIRE(count == 2);
+        REQUIRE(latch.try_wait());
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    SUBCASE("barrier") {
+        constexpr auto thread_count = 3;
+        constexpr auto phase_count = 50;
+        shard::barrier barrier(thread_count + 1);
+
+        std::atomic<int> count = 0;
+        std::vector<std::thread> threads;
+        for (auto i = 0; i < thread_count; ++i) {
+            threads.emplace_back([&, i] {
+                for (auto phase = 0; phase < phase_count; ++phase) {
+                    ++count;
+                    barrier.arrive_and_wait();
+                    barrier.arrive_and_wait();
+                }
+                if (i == 0) {
+                    barrier.arrive_and_drop();
+                }
+            });
+        }
+        for (auto phase = 0; phase < phase_count; ++phase) {
+            barrier.arrive_and_wait();
+            // every thread has finished the current phase
+            REQUIRE(count == thread_count * (phase + 1));
+            barrier.arrive_and_wait();
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    SUBCASE("thread_pool") {
+        auto scheduling = shard::scheduling_t::shared_queue;
+
+        SUBCASE("shared_queue") {
+            scheduling = shard::scheduling_t::shared_queue;
+        }
+
+        SUBCASE("work_stealing") {
+            scheduling = shard::scheduling_t::work_stealing;
+        }
+
+        shard::thread_pool pool(4, scheduling);
+        REQUIRE(pool.thread_count() == 4);
+        REQUIRE(pool.scheduling() == scheduling);
+
+        SUBCASE("run") {
+            std::atomic<int> counter = 0;
+            for (auto i = 0; i < 1000; ++i) {
+                pool.run([&counter] { ++counter; });
+            }
+            REQUIRE(wait_until([&] { return counter == 1000; }));
+        }
+
+        SUBCASE("run with arguments") {
+            std::atomic<int> counter = 0;
+            pool.run([&counter](int n) { counter += n; }, 42);
+            REQUIRE(wait_until([&] { return counter == 42; }));
+        }
+
+        SUBCASE("nested tasks") {
+            std::atomic<int> counter = 0;
+            for (auto i = 0; i < 100; ++i) {
+                pool.run([&pool, &counter] {
+                    for (auto j = 0; j < 100; ++j) {
+                        pool.run([&counter] { ++counter; });
+                    }
+                });
+            }
+            REQUIRE(wait_until([&] { return counter == 10000; }));
+        }
+
+        SUBCASE("submit") {
+            auto f = pool.submit([](int a, int b) { return a + b; }, 40, 2);
+            REQUIRE(f.is_valid());
+            REQUIRE(f.get() == 42);
+            REQUIRE_FALSE(f.is_valid());
+
+            auto v = pool.submit([] {});
+            v.wait();
+            REQUIRE(v.is_ready());
+        }
+
+        SUBCASE("submit throwing") {
+            auto f = pool.submit([]() -> int { throw std::runtime_error("error"); });
+            REQUIRE_THROWS_AS(f.get(), std::runtime_error);
+        }
+
+        SUBCASE("then") {
+            auto f = pool.submit([] { return 21; })
+                         .then([](int n) { return n * 2; })
+                         .then([](int n) { return std::to_string(n); });
+            REQUIRE(f.get() == "42");
+
+            auto g = pool.submit([]() -> int { throw std::runtime_error("error"); }).then([](int n) { return n; });
+            REQUIRE_THROWS_AS(g.get(), std::runtime_error);
+        }
+
+        SUBCASE("stopped") {
+            pool.stop();
+            auto f = pool.submit([] { return 42; });
+            REQUIRE_THROWS_AS(f.get(), std::future_error);
+        }
+
+        SUBCASE("placement") {
+            auto available = shard::this_thread::affinity();
+            REQUIRE_FALSE(available.is_empty());
+
+            shard::thread_pool_options options;
+            options.thread_count = 2;
+            options.scheduling = scheduling;
+            options.placement = shard::placement_t::compact;
+            options.name = "worker";
+            shard::thread_pool placed(options);
+
+            auto cpu = placed.submit([] { return shard::this_thread::affinity(); }).get();
+            REQUIRE(cpu.count() == 1);
+            REQUIRE(available.contains(cpu.nth(0)));
+
+            options.placement = shard::placement_t::cpu_list;
+            options.cpus = {available.nth(0), shard::cpu_set::max_size};
+            REQUIRE_THROWS_AS(shard::thread_pool {options}, std::out_of_range);
+            options.cpus.clear();
+            REQUIRE_THROWS_AS(shard::thread_pool {options}, std::invalid_argument);
+        }
+
+        SUBCASE("priority") {
+            shard::thread_pool_options options;
+            options.thread_count = 1;
+            options.scheduling = scheduling;
+            options.aging = std::chrono::hours(1);
+
+            SUBCASE("levels") {}
+
+            SUBCASE("aging") {
+                options.aging = std::chrono::milliseconds(1);
+            }
+
+            shard::thread_pool single(options);
+            std::atomic<bool> is_blocked = true;
+            single.run([&is_blocked] { wait_until([&] { return !is_blocked; }); });
+
+            std::vector<shard::priority_t> order;
+            std::atomic<std::size_t> count = 0;
+            auto record = [&](shard::priority_t priority) {
+                order.push_back(priority);
+                ++count;
+            };
+            single.run(shard::priority_t::background, record, shard::priority_t::background);
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            single.run(shard::priority_t::normal, record, shard::priority_t::normal);
+            auto high = single.submit(shard::priority_t::high, record, shard::priority_t::high);
+            is_blocked = false;
+            high.wait();
+            REQUIRE(wait_until([&] { return count == 3; }));
+
+            if (options.aging == std::chrono::milliseconds(1)) {
+                // the background task has waited the longest
+                REQUIRE(order.front() == shard::priority_t::background);
+            } else {
+                REQUIRE(order.front() == shard::priority_t::high);
+                REQUIRE(order.back() == shard::priority_t::background);
+            }
+        }
+
+        SUBCASE("aging with busy threads") {
+            // only the work-stealing threads have local work going first
+            shard::thread_pool_options options;
+            options.thread_count = 1;
+            options.scheduling = shard::scheduling_t::work_stealing;
+            options.aging = std::chrono::milliseconds(1);
+
+            // the thread always has a normal task of its own to run next, the
+            // function outlives the pool
+            std::atomic<bool> is_stopped = false;
+            shard::thread_pool* target = nullptr;
+            std::function<void()> respawn = [&] {
+                if (!is_stopped) {
+                    target->run(respawn);
+                }
+            };
+            shard::thread_pool single(options);
+            target = &single;
+            single.run(respawn);
+
+            std::atomic<bool> is_done = false;
+            single.run(shard::priority_t::background, [&is_done] { is_done = true; });
+            REQUIRE(wait_until([&] { return is_done.load(); }));
+            is_stopped = true;
+        }
+
+        SUBCASE("run_after") {
+            std::atomic<int> counter = 0;
+            auto start = std::chrono::steady_clock::now();
+            std::atomic<std::chrono::steady_clock::duration::rep> elapsed = 0;
+            pool.run_after(std::chrono::milliseconds(20), [&] {
+                elapsed = (std::chrono::steady_clock::now() - start).count();
+                ++counter;
+            });
+            pool.run_at(std::chrono::system_clock::now() + std::chrono::milliseconds(5), [&counter] { ++counter; });
+            // discarded when the pool is stopped
+            pool.run_after(std::chrono::hours(1), [&counter] { ++counter; });
+            REQUIRE(wait_until([&] { return counter == 2; }));
+            REQUIRE(std::chrono::steady_clock::duration(elapsed) >= std::chrono::milliseconds(20));
+            pool.stop();
+            REQUIRE(counter == 2);
+        }
+
+        SUBCASE("metrics") {
+            std::atomic<int> counter = 0;
+            auto run_tasks = [&counter](shard::thread_pool& p) {
+                counter = 0;
+                for (auto i = 0; i < 100; ++i) {
+                    p.run([&counter] {
+                        std::this_thread::sleep_for(std::chrono::microseconds(10));
+                        ++counter;
+                    });
+                }
+                REQUIRE(wait_until([&] { return p.metrics().tasks_executed() == 100; }));
+                REQUIRE(counter == 100);
+            };
+
+            // only the counters by default
+            run_tasks(pool);
+            auto metrics = pool.metrics();
+            REQUIRE(metrics.workers.size() == 4);
+            REQUIRE(metrics.queue_latency.count() == 0);
+            REQUIRE(metrics.utilization() == 0.0);
+
+            shard::thread_pool_options options;
+            options.thread_count = 4;
+            options.scheduling = scheduling;
+            options.collect_metrics = true;
+            shard::thread_pool timed(options);
+            run_tasks(timed);
+            metrics = timed.metrics();
+            REQUIRE(metrics.queue_latency.count() == 100);
+            REQUIRE(metrics.queued_tasks == 0);
+            REQUIRE(metrics.utilization() > 0.0);
+            REQUIRE(metrics.queue_latency.percentile(0.5) <= metrics.queue_latency.percentile(1.0));
+        }
+    }
+
+#if SHARD_HAS_COROUTINES
+    SUBCASE("coroutines") {
+        shard::thread_pool pool(2);
+
+        SUBCASE("task") {
+            auto add = [](int a, int b) -> shard::task<int> { co_return a + b; };
+            auto pipeline = [&pool, &add]() -> shard::task<std::string> {
+                co_await pool.schedule();
+                auto n = co_await add(40, 2);
+                co_return std::to_string(n);
+            };
+            REQUIRE(shard::sync_wait(pipeline()) == "42");
+
+            auto throwing = []() -> shard::task<> {
+                throw std::runtime_error("error");
+                co_return;
+            };
+            REQUIRE_THROWS_AS(shard::sync_wait(throwing()), std::runtime_error);
+        }
+
+        SUBCASE("pop_async") {
+            shard::channel<int> channel;
+            std::atomic<int> sum = 0;
+            std::atomic<int> done = 0;
+            auto consumer = [&]() -> shard::task<> {
+                while (auto value = co_await channel.pop_async()) {
+                    sum += *value;
+                }
+                ++done;
+            };
+            // the suspended consumers do not hold the threads of the pool
+            for (auto i = 0; i < 1000; ++i) {
+                shard::spawn(pool, consumer());
+            }
+            for (auto i = 1; i <= 2000; ++i) {
+                channel.push(i);
+            }
+            REQUIRE(wait_until([&] { return sum == 2001000; }));
+            channel.close();
+            REQUIRE(wait_until([&] { return done == 1000; }));
+        }
+
+        SUBCASE("async_semaphore") {
+            shard::async_semaphore semaphore(1);
+            std::atomic<int> count = 0;
+            auto worker = [&]() -> shard::task<> {
+                co_await semaphore.acquire();
+                ++count;
+            };
+            for (auto i = 0; i < 10; ++i) {
+                shard::spawn(pool, worker());
+            }
+            REQUIRE(wait_until([&] { return count == 1; }));
+            REQUIRE_FALSE(semaphore.try_acquire());
+            semaphore.release(9);
+            REQUIRE(wait_until([&] { return count == 10; }));
+        }
+    }
+#endif
+
+    SUBCASE("task_graph") {
+        shard::thread_pool pool(4, shard::scheduling_t::work_stealing);
+        shard::task_graph graph;
+        REQUIRE(graph.is_empty());
+
+        // parse -> transform x N -> merge
+        std::vector<int> input;
+        std::vector<int> output(8);
+        int sum = 0;
+        auto parse = graph.emplace([&] {
+            input.resize(output.size());
+            std::iota(input.begin(), input.end(), 1);
+        });
+        auto merge = graph.emplace([&] { sum = std::accumulate(output.begin(), output.end(), 0); });
+        for (std::size_t i = 0; i < output.size(); ++i) {
+            graph.emplace([&, i] { output[i] = input[i] * 2; }).succeed(parse).precede(merge);
+        }
+        REQUIRE(graph.size() == 10);
+        REQUIRE(graph.is_acyclic());
+
+        // the graph can be run again
+        for (auto run = 0; run < 3; ++run) {
+            sum = 0;
+            graph.run(pool);
+            REQUIRE(sum == 72);
+        }
+
+        auto failing = graph.emplace([] { throw std::runtime_error("error"); });
+        failing.precede(parse);
+        REQUIRE_THROWS_AS(graph.run(pool), std::runtime_error);
+
+        merge.precede(failing);
+        REQUIRE_FALSE(graph.is_acyclic());
+        sum = 0;
+        REQUIRE_THROWS_AS(graph.run(pool), std::logic_error);
+        REQUIRE(sum == 0);
+        graph.clear();
+        REQUIRE(graph.is_empty());
+    }
+
+    SUBCASE("this_thread") {
+        shard::cpu_set cpus;
+        REQUIRE(cpus.is_empty());
+        cpus.add(3);
+        cpus.add(7);
+        REQUIRE(cpus.count() == 2);
+        REQUIRE(cpus.contains(7));
+        REQUIRE(cpus.nth(1) == 7);
+        cpus.remove(3);
+        REQUIRE(cpus.nth(0) == 7);
+        cpus.add(shard::cpu_set::max_size);
+        REQUIRE(cpus.count() == 1);
+
+        auto available = shard::this_thread::affinity();
+        std::thread thread([&available] {
+            shard::cpu_set single;
+            single.add(available.nth(0));
+            REQUIRE(shard::this_thread::set_affinity(single));
+            REQUIRE(shard::this_thread::affinity() == single);
+            REQUIRE(shard::this_thread::current_cpu() == available.nth(0));
+            REQUIRE(shard::this_thread::numa_node().has_value());
+            REQUIRE(shard::this_thread::scheduling_policy() == shard::scheduling_policy_t::normal);
+            REQUIRE(shard::this_thread::set_scheduling(shard::scheduling_policy_t::batch));
+            REQUIRE(shard::this_thread::scheduling_policy() == shard::scheduling_policy_t::batch);
+        });
+        thread.join();
+    }
+
+    SUBCASE("parallel") {
+        auto scheduling = shard::scheduling_t::shared_queue;
+
+        SUBCASE("shared_queue") {
+            scheduling = shard::scheduling_t::shared_queue;
+        }
+
+        SUBCASE("work_stealing") {
+            scheduling = shard::scheduling_t::work_stealing;
+        }
+
+        shard::thread_pool pool(4, scheduling);
+
+        std::vector<int> values(10000);
+        std::iota(values.begin(), values.end(), 0);
+
+        SUBCASE("parallel_for indices") {
+            std::vector<int> result(values.size());
+            shard::parallel_for(pool, std::size_t(0), result.size(), 64, [&](std::size_t i) {
+                result[i] = static_cast<int>(i);
+            });
+            REQUIRE(result == values);
+        }
+
+        SUBCASE("parallel_for span") {
+            shard::span<int> span(values);
+            shard::parallel_for(pool, span, [](int& n) { n *= 2; });
+            REQUIRE(values[1] == 2);
+            REQUIRE(values.back() == 19998);
+        }
+
+        SUBCASE("parallel_for enumerate") {
+            std::list<int> list(values.begin(), values.end());
+            shard::parallel_for(pool, shard::enumerate(list), 100, [](auto& item) {
+                item.value() = static_cast<int>(item.index()) + 1;
+            });
+            REQUIRE(list.front() == 1);
+            REQUIRE(list.back() == 10000);
+        }
+
+        SUBCASE("parallel_for nested") {
+            std::atomic<int> counter = 0;
+            shard::parallel_for(pool, 0, 8, 1, [&](int) {
+                shard::parallel_for(pool, 0, 100, 10, [&](int) { ++counter; });
+            });
+            REQUIRE(counter == 800);
+        }
+
+        SUBCASE("parallel_for throwing") {
+            auto fn = [](int i) {
+                if (i == 500) {
+                    throw std::runtime_error("error");
+                }
+            };
+            REQUIRE_THROWS_AS(shard::parallel_for(pool, 0, 1000, 10, fn), std::runtime_error);
+        }
+
+        SUBCASE("parallel_reduce") {
+            auto sum = shard::parallel_reduce(pool, values, std::int64_t(0), [](std::int64_t a, std::int64_t b) {
+                return a + b;
+            });
+            REQUIRE(sum == std::int64_t(9999) * 10000 / 2);
+        }
+
+        SUBCASE("parallel_transform") {
+            std::vector<int> result(values.size());
+            auto end = shard::parallel_transform(pool, values, result.begin(), 128, [](int n) { return n * 3; });
+            REQUIRE(end == result.end());
+            REQUIRE(result[100] == 300);
+            REQUIRE(result.back() == 29997);
+        }
+
+        SUBCASE("parallel_sort") {
+            std::vector<int> data(50000);
+            std::mt19937 rng(42);
+            std::generate(data.begin(), data.end(), [&] { return static_cast<int>(rng() % 1000); });
+            auto expected = data;
+            std::sort(expected.begin(), expected.end(), std::greater<>());
+            shard::parallel_sort(pool, data.begin(), data.end(), std::greater<>());
+            REQUIRE(data == expected);
+
+            // equal keys keep their order, an even number of merge rounds
+            // ends in the buffer
+            std::vector<std::pair<int, std::string>> items(8000);
+            for (std::size_t i = 0; i < items.size(); ++i) {
+                items[i] = {static_cast<int>(rng() % 100), std::to_string(i)};
+            }
+            auto stable = items;
+            auto by_key = [](const auto& a, const auto& b) { return a.first < b.first; };
+            std::stable_sort(stable.begin(), stable.end(), by_key);
+            shard::parallel_sort(pool, items.begin(), items.end(), by_key);
+            REQUIRE(items == stable);
+        }
+    }
+
+    SUBCASE("rate_limiter") {
+        SUBCASE("burst") {
+            shard::rate_limiter limiter(1.0 / 3600, 3);
+            REQUIRE(limiter.burst() == 3);
+            REQUIRE(limiter.is_idle());
+            REQUIRE(limiter.try_acquire(2));
+            REQUIRE_FALSE(limiter.try_acquire(2));
+            REQUIRE(limiter.try_acquire());
+            REQUIRE_FALSE(limiter.try_acquire());
+            REQUIRE_FALSE(limiter.is_idle());
+        }
+
+        SUBCASE("acquire") {
+            shard::rate_limiter limiter(100.0);
+            REQUIRE(limiter.rate() == doctest::Approx(100.0));
+            limiter.acquire();
+            auto start = std::chrono::steady_clock::now();
+            limiter.acquire();
+            REQUIRE(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(5));
+            REQUIRE(limiter.reserve() > std::chrono::steady_clock::now());
+        }
+
+        SUBCASE("concurrent") {
+            shard::rate_limiter limiter(1.0 / 3600, 100);
+            std::atomic<int> acquired = 0;
+            std::vector<std::thread> threads;
+            for (auto t = 0; t < 4; ++t) {
+                threads.emplace_back([&] {
+                    for (auto i = 0; i < 100; ++i) {
+                        if (limiter.try_acquire()) {
+                            ++acquired;
+                        }
+                    }
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            REQUIRE(acquired == 100);
+        }
+
+        SUBCASE("keyed") {
+            shard::keyed_rate_limiter<std::string, 4> limiter(1000.0, 2);
+            REQUIRE(limiter.try_acquire("a", 2));
+            REQUIRE_FALSE(limiter.try_acquire("a"));
+            REQUIRE(limiter.try_acquire("b"));
+            limiter.acquire("b");
+            REQUIRE(limiter.size() == 2);
+            // the limiters are removed once their burst is replenished
+            REQUIRE(wait_until([&] {
+                limiter.prune();
+                return limiter.size() == 0;
+            }));
+        }
+    }
+
+    SUBCASE("seq_value") {
+        struct pair {
+            std::int64_t first;
+            std::int64_t second;
+        };
+
+        shard::seq_value<pair> value(pair {1, 1});
+        REQUIRE(value.load().first == 1);
+
+        std::atomic<bool> done = false;
+        std::thread writer([&] {
+            for (std::int64_t i = 2; i < 2000; ++i) {
+                value.store(pair {i, i});
+            }
+            done = true;
+        });
+        std::int64_t last = 0;
+        while (!done) {
+            auto p = value.load();
+            // never torn and never going back in time
+            REQUIRE(p.first == p.second);
+            REQUIRE(p.first >= last);
+            last = p.first;
+        }
+        writer.join();
+        REQUIRE(value.load().first == 1999);
+    }
+
+    SUBCASE("snapshot_value") {
+        shard::snapshot_value<std::vector<int>, 2> value(std::vector<int>(100, 0));
+        REQUIRE(value.load()->size() == 100);
+
+        std::atomic<bool> done = false;
+        std::thread writer([&] {
+            for (auto i = 1; i < 500; ++i) {
+                value.store(std::vector<int>(100, i));
+            }
+            done = true;
+        });
+        std::vector<std::thread> readers;
+        std::atomic<bool> is_consistent = true;
+        for (auto r = 0; r < 2; ++r) {
+            readers.emplace_back([&] {
+                while (!done) {
+                    auto view = value.load();
+                    const auto& v = *view;
+                    if (std::any_of(v.begin(), v.end(), [&](int n) { return n != v.front(); })) {
+                        is_consistent = false;
+                    }
+                }
+            });
+        }
+        writer.join();
+        for (auto& reader : readers) {
+            reader.join();
+        }
+        REQUIRE(is_consistent);
+        REQUIRE(value.load()->front() == 499);
     }
 
     SUBCASE("thread_safe") {
@@ -109,5 +1258,118 @@ TEST_CASE("concurrency") {
                 REQUIRE(w->b == 42);
             }
         }
+
+        SUBCASE("rcu") {
+            using rcu_widget = shard::rcu_thread_safe<test::widget>;
+            rcu_widget rcu(42, 21);
+            {
+                shard::read_access<rcu_widget> r(rcu);
+                shard::write_access<rcu_widget> w(rcu);
+                std::swap(w->a, w->b);
+                // the readers keep seeing the previous version
+                REQUIRE(r->a == 42);
+            }
+            shard::read_access<rcu_widget> r(rcu);
+            REQUIRE(r->a == 21);
+            REQUIRE(r->b == 42);
+        }
+
+        SUBCASE("rcu concurrent") {
+            using rcu_vector = shard::rcu_thread_safe<std::vector<int>>;
+            rcu_vector rcu(std::vector<int>(64, 0));
+
+            std::atomic<bool> done = false;
+            std::atomic<bool> is_consistent = true;
+            std::vector<std::thread> readers;
+            for (auto i = 0; i < 2; ++i) {
+                readers.emplace_back([&] {
+                    while (!done) {
+                        shard::read_access<rcu_vector> r(rcu);
+                        if (std::any_of(r->begin(), r->end(), [&](int n) { return n != r->front(); })) {
+                            is_consistent = false;
+                        }
+                    }
+                });
+            }
+            for (auto i = 1; i <= 200; ++i) {
+                shard::write_access<rcu_vector> w(rcu);
+                std::fill(w->begin(), w->end(), i);
+            }
+            done = true;
+            for (auto& reader : readers) {
+                reader.join();
+            }
+            REQUIRE(is_consistent);
+            REQUIRE(rcu.unsafe().front() == 200);
+        }
+
+        SUBCASE("sharded") {
+            using sharded_map = shard::sharded_thread_safe<std::unordered_map<int, int>, 8>;
+            sharded_map map;
+            REQUIRE(map.shard_count() == 8);
+
+            std::vector<std::thread> threads;
+            for (auto t = 0; t < 2; ++t) {
+                threads.emplace_back([&map, t] {
+                    for (auto i = 0; i < 500; ++i) {
+                        auto w = map.write_access(t * 500 + i);
+                        (*w)[t * 500 + i] = i;
+                    }
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+
+            REQUIRE(map.read_access(742)->at(742) == 242);
+            std::size_t size = 0;
+            std::size_t used = 0;
+            std::as_const(map).for_each_shard([&](const auto& m) {
+                size += m.size();
+                used += m.empty() ? 0 : 1;
+            });
+            REQUIRE(size == 1000);
+            REQUIRE(used == 8);
+
+            map.for_each_shard([](auto& m) { m.clear(); });
+            REQUIRE(map.read_access(742)->empty());
+        }
+
+        SUBCASE("spin mutexes") {
+            auto increment = [](auto& counter) {
+                using counter_type = std::remove_reference_t<decltype(counter)>;
+                std::vector<std::thread> threads;
+                for (auto t = 0; t < 2; ++t) {
+                    threads.emplace_back([&counter] {
+                        for (auto i = 0; i < 1000; ++i) {
+                            shard::write_access<counter_type> w(counter);
+                            ++*w;
+                        }
+                    });
+                }
+                for (auto& thread : threads) {
+                    thread.join();
+                }
+                // the default read lock is exclusive for non-shared mutexes
+                return *shard::read_access<counter_type>(counter);
+            };
+
+            shard::basic_thread_safe<int, shard::spin_mutex> spin(0);
+            REQUIRE(increment(spin) == 2000);
+            shard::basic_thread_safe<int, shard::adaptive_mutex> adaptive(0);
+            REQUIRE(increment(adaptive) == 2000);
+            shard::basic_thread_safe<int, shard::rw_spin_mutex> rw_spin(0);
+            REQUIRE(increment(rw_spin) == 2000);
+
+            shard::rw_spin_mutex mutex;
+            REQUIRE(mutex.try_lock_shared());
+            REQUIRE(mutex.try_lock_shared());
+            REQUIRE_FALSE(mutex.try_lock());
+            mutex.unlock_shared();
+            mutex.unlock_shared();
+            REQUIRE(mutex.try_lock());
+            REQUIRE_FALSE(mutex.try_lock_shared());
+            mutex.unlock();
+        }
     }
 }